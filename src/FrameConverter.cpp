@@ -0,0 +1,166 @@
+#include <opencv2/opencv.hpp>
+
+#include "FrameConverter.h"
+#include "Logger.h"
+
+// 2x2 super-pixel demosaic, much cheaper than a full demosaic when the result
+// is decimated anyway. Channel order matches the full-frame path (RGB888).
+static cv::Mat binBayerBGGR8(const cv::Mat &bayer)
+{
+    cv::Mat rgb(bayer.rows / 2, bayer.cols / 2, CV_8UC3);
+    for (int y = 0; y < rgb.rows; ++y) {
+        const uchar *row0 = bayer.ptr<uchar>(2 * y);
+        const uchar *row1 = bayer.ptr<uchar>(2 * y + 1);
+        uchar *out = rgb.ptr<uchar>(y);
+        for (int x = 0; x < rgb.cols; ++x) {
+            out[3 * x + 0] = row1[2 * x + 1];                       // R
+            out[3 * x + 1] = (row0[2 * x + 1] + row1[2 * x]) >> 1;  // G
+            out[3 * x + 2] = row0[2 * x];                           // B
+        }
+    }
+    return rgb;
+}
+
+qint64 FrameConverter::bodyLength(quint32 format, quint32 width, quint32 height)
+{
+    const qint64 pixels = static_cast<qint64>(width) * height;
+    switch (format) {
+    case PIX_FMT_SBGGR8:
+        return pixels;
+    case PIX_FMT_NV12:
+        return pixels * 3 / 2;
+    case PIX_FMT_RGB565:
+        return pixels * 2;
+    default:
+        return 0;
+    }
+}
+
+QImage FrameConverter::convertRegion(const QByteArray &data, quint32 format, int width, int height,
+                                     const QRect &region, int level)
+{
+    const qint64 needed = bodyLength(format, width, height);
+    if (needed == 0 || data.size() < needed || level < 0) {
+        LOG_DEBUG("convertRegion: unsupported frame - format:" << format << "size:" << data.size() << "needed:" << needed);
+        return QImage();
+    }
+
+    // Chroma and Bayer quads need even coordinates, decimated NV12 needs multiples of 4
+    const int align = level > 0 ? 4 : 2;
+    QRect clipped = region.intersected(QRect(0, 0, width, height));
+    if (clipped.isEmpty()) {
+        return QImage();
+    }
+    const int x0 = clipped.left() & ~(align - 1);
+    const int y0 = clipped.top() & ~(align - 1);
+    const int x1 = qMin((clipped.right() + align) & ~(align - 1), width & ~(align - 1));
+    const int y1 = qMin((clipped.bottom() + align) & ~(align - 1), height & ~(align - 1));
+    if (x1 <= x0 || y1 <= y0) {
+        return QImage();
+    }
+    const cv::Rect roi(x0, y0, x1 - x0, y1 - y0);
+    const cv::Size target(qMax(1, roi.width >> level), qMax(1, roi.height >> level));
+    uchar *pixels = reinterpret_cast<uchar*>(const_cast<char*>(data.constData()));
+
+    try {
+        cv::Mat rgbMat;
+        if (format == PIX_FMT_SBGGR8) {
+            cv::Mat bayerMat(height, width, CV_8UC1, pixels);
+            if (level == 0) {
+                // Demosaic with a small margin so tile borders look like the full frame
+                const int px0 = qMax(0, x0 - 2);
+                const int py0 = qMax(0, y0 - 2);
+                const int px1 = qMin(width & ~1, x1 + 2);
+                const int py1 = qMin(height & ~1, y1 + 2);
+                cv::Mat padded;
+                cv::cvtColor(bayerMat(cv::Rect(px0, py0, px1 - px0, py1 - py0)), padded, cv::COLOR_BayerBG2BGR);
+                rgbMat = padded(cv::Rect(x0 - px0, y0 - py0, roi.width, roi.height));
+            } else {
+                rgbMat = binBayerBGGR8(bayerMat(roi));
+            }
+        } else if (format == PIX_FMT_NV12) {
+            cv::Mat yMat(height, width, CV_8UC1, pixels);
+            cv::Mat uvMat(height / 2, width / 2, CV_8UC2, pixels + width * height);
+            cv::Mat yRoi = yMat(roi);
+            cv::Mat uvRoi = uvMat(cv::Rect(x0 / 2, y0 / 2, roi.width / 2, roi.height / 2));
+            if (level == 0) {
+                cv::cvtColorTwoPlane(yRoi, uvRoi, rgbMat, cv::COLOR_YUV2RGB_NV12);
+            } else {
+                // Decimate both planes first so the colour conversion runs on a quarter of the pixels
+                cv::Mat ySmall, uvSmall;
+                cv::resize(yRoi, ySmall, cv::Size(yRoi.cols / 2, yRoi.rows / 2), 0, 0, cv::INTER_NEAREST);
+                cv::resize(uvRoi, uvSmall, cv::Size(uvRoi.cols / 2, uvRoi.rows / 2), 0, 0, cv::INTER_NEAREST);
+                cv::cvtColorTwoPlane(ySmall, uvSmall, rgbMat, cv::COLOR_YUV2RGB_NV12);
+            }
+        } else {
+            // RGB565 (byte order as sent by the camera, swapped like the full-frame path)
+            cv::Mat rgb565Mat(height, width, CV_8UC2, pixels);
+            cv::Mat scaled = rgb565Mat(roi);
+            if (level > 0) {
+                cv::Mat decimated;
+                cv::resize(scaled, decimated, target, 0, 0, cv::INTER_NEAREST);
+                scaled = decimated;
+            }
+            QImage qimg(scaled.data, scaled.cols, scaled.rows, scaled.step, QImage::Format_RGB16);
+            return qimg.copy().rgbSwapped();
+        }
+
+        if (rgbMat.cols != target.width || rgbMat.rows != target.height) {
+            cv::Mat scaled;
+            cv::resize(rgbMat, scaled, target, 0, 0, cv::INTER_AREA);
+            rgbMat = scaled;
+        }
+
+        QImage qimg(rgbMat.data, rgbMat.cols, rgbMat.rows, rgbMat.step, QImage::Format_RGB888);
+        return qimg.copy(); // Make a deep copy
+
+    } catch (const cv::Exception& e) {
+        LOG_DEBUG("convertRegion OpenCV error:" << e.what());
+        return QImage();
+    }
+}
+
+QVariantMap FrameConverter::pixelAt(const QByteArray &data, quint32 format, int width, int height, int x, int y)
+{
+    QVariantMap result;
+    const qint64 needed = bodyLength(format, width, height);
+    if (needed == 0 || data.size() < needed || x < 0 || y < 0 || x >= width || y >= height) {
+        result["text"] = QString("N/A");
+        return result;
+    }
+
+    const uchar *pixels = reinterpret_cast<const uchar*>(data.constData());
+    result["x"] = x;
+    result["y"] = y;
+
+    if (format == PIX_FMT_SBGGR8) {
+        static const char *channels[2][2] = { { "B", "Gb" }, { "Gr", "R" } };
+        const int value = pixels[y * width + x];
+        const QString channel = channels[y & 1][x & 1];
+        result["channel"] = channel;
+        result["value"] = value;
+        result["text"] = QString("%1: %2").arg(channel).arg(value);
+    } else if (format == PIX_FMT_NV12) {
+        const uchar *uv = pixels + width * height + (y / 2) * width + (x & ~1);
+        const int luma = pixels[y * width + x];
+        const int u = uv[0];
+        const int v = uv[1];
+        result["luma"] = luma;
+        result["u"] = u;
+        result["v"] = v;
+        result["text"] = QString("Y: %1 U: %2 V: %3").arg(luma).arg(u).arg(v);
+    } else {
+        const uchar *p = pixels + (y * width + x) * 2;
+        const int value = p[0] | (p[1] << 8);
+        const int b = value >> 11;
+        const int g = (value >> 5) & 0x3f;
+        const int r = value & 0x1f;
+        result["value"] = value;
+        result["r"] = r;
+        result["g"] = g;
+        result["b"] = b;
+        result["text"] = QString("0x%1 R: %2 G: %3 B: %4")
+                         .arg(value, 4, 16, QChar('0')).arg(r).arg(g).arg(b);
+    }
+    return result;
+}
@@ -0,0 +1,29 @@
+#ifndef FRAMECONVERTER_H
+#define FRAMECONVERTER_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QRect>
+#include <QVariantMap>
+
+#include "utils.h"
+
+// Region based conversion straight from a received frame buffer.
+// Used by the pixel inspector so only the visible tiles of a large frame are
+// converted, and the raw values under the cursor are read without conversion.
+class FrameConverter
+{
+public:
+    // Size in bytes of a frame body, 0 for formats we cannot display
+    static qint64 bodyLength(quint32 format, quint32 width, quint32 height);
+
+    // Convert the given region of a frame. level N decimates by 2^N, so the
+    // returned image is roughly region.size() / 2^N (clipped to the frame).
+    static QImage convertRegion(const QByteArray &data, quint32 format, int width, int height,
+                                const QRect &region, int level);
+
+    // Raw values of one pixel, keys depend on the format. "text" is always set.
+    static QVariantMap pixelAt(const QByteArray &data, quint32 format, int width, int height, int x, int y);
+};
+
+#endif // FRAMECONVERTER_H
@@ -0,0 +1,177 @@
+#include <algorithm>
+
+#include "FrameSyncBuffer.h"
+#include "Logger.h"
+
+FrameSyncBuffer::FrameSyncBuffer()
+    : m_mode(ByFrameId)
+    , m_toleranceMs(0)
+    , m_deadlineMs(100)
+    , m_maxPendingSets(8)
+    , m_maxPendingBytes(256LL * 1024 * 1024)
+    , m_pendingBytes(0)
+    , m_completeSets(0)
+    , m_incompleteSets(0)
+    , m_droppedSets(0)
+{
+}
+
+void FrameSyncBuffer::setLimits(int maxPendingSets, qint64 maxPendingBytes)
+{
+    if (maxPendingSets > 0) {
+        m_maxPendingSets = maxPendingSets;
+    }
+    if (maxPendingBytes > 0) {
+        m_maxPendingBytes = maxPendingBytes;
+    }
+}
+
+QList<FrameSyncBuffer::FrameSet> FrameSyncBuffer::push(const Frame &frame, qint64 nowMs)
+{
+    QList<FrameSet> ready;
+    const int pipeId = frame.header.pic_info.pipe_id;
+    trackArrival(pipeId, nowMs);
+
+    int index = findSet(frame, nowMs);
+    if (index < 0) {
+        PendingSet set;
+        set.frameId = frame.header.pic_info.frame_id;
+        set.firstArrivalMs = nowMs;
+        set.bytes = 0;
+        m_pending.append(set);
+        index = m_pending.size() - 1;
+    }
+
+    PendingSet &set = m_pending[index];
+    auto existing = set.frames.constFind(pipeId);
+    if (existing != set.frames.constEnd()) {
+        // Same pipe twice for one instant, keep the newest
+        set.bytes -= existing->body.size();
+        m_pendingBytes -= existing->body.size();
+    }
+    set.frames.insert(pipeId, frame);
+    set.bytes += frame.body.size();
+    m_pendingBytes += frame.body.size();
+
+    if (isComplete(set)) {
+        // Older sets can no longer be shown without going back in time
+        for (int i = 0; i < index; ++i) {
+            m_incompleteSets++;
+            dropSet(0);
+        }
+        ready.append(takeSet(0));
+        m_completeSets++;
+    }
+
+    // Bound memory: evict the oldest sets
+    while (m_pending.size() > m_maxPendingSets || (m_pendingBytes > m_maxPendingBytes && m_pending.size() > 1)) {
+        m_droppedSets++;
+        dropSet(0);
+    }
+    return ready;
+}
+
+void FrameSyncBuffer::expire(qint64 nowMs)
+{
+    while (!m_pending.isEmpty() && nowMs - m_pending.first().firstArrivalMs > m_deadlineMs) {
+        LOG_DEBUG("FrameSyncBuffer: set" << m_pending.first().frameId << "missed the deadline with"
+                  << m_pending.first().frames.size() << "of" << m_expectedPipes.size() << "pipes");
+        m_incompleteSets++;
+        dropSet(0);
+    }
+}
+
+void FrameSyncBuffer::clear()
+{
+    m_pending.clear();
+    m_pendingBytes = 0;
+    m_lastArrivalMs.clear();
+    m_intervalMs.clear();
+    m_completeSets = 0;
+    m_incompleteSets = 0;
+    m_droppedSets = 0;
+}
+
+int FrameSyncBuffer::effectiveToleranceMs() const
+{
+    if (m_toleranceMs > 0) {
+        return m_toleranceMs;
+    }
+    // The frames of one instant share the stream, so they arrive spread over up
+    // to a frame interval. Most of the shortest interval groups them without
+    // reaching into the next instant (a set never takes a pipe twice anyway)
+    double interval = 0.0;
+    for (double pipeInterval : m_intervalMs) {
+        if (interval == 0.0 || pipeInterval < interval) {
+            interval = pipeInterval;
+        }
+    }
+    return interval > 0.0 ? qMax(1, static_cast<int>(interval * 0.9)) : DefaultToleranceMs;
+}
+
+void FrameSyncBuffer::trackArrival(int pipeId, qint64 nowMs)
+{
+    auto last = m_lastArrivalMs.find(pipeId);
+    if (last == m_lastArrivalMs.end()) {
+        m_lastArrivalMs.insert(pipeId, nowMs);
+        return;
+    }
+    const double delta = nowMs - last.value();
+    last.value() = nowMs;
+    if (delta > MaxIntervalMs) {
+        return;   // the pipe paused, not a frame interval
+    }
+    double &interval = m_intervalMs[pipeId];
+    interval = interval > 0.0 ? interval * 0.875 + delta * 0.125 : delta;
+}
+
+int FrameSyncBuffer::findSet(const Frame &frame, qint64 nowMs) const
+{
+    const int pipeId = frame.header.pic_info.pipe_id;
+    const int toleranceMs = effectiveToleranceMs();
+    for (int i = 0; i < m_pending.size(); ++i) {
+        const PendingSet &set = m_pending.at(i);
+        if (m_mode == ByFrameId) {
+            if (set.frameId == frame.header.pic_info.frame_id) {
+                return i;
+            }
+        } else if (nowMs - set.firstArrivalMs <= toleranceMs && !set.frames.contains(pipeId)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool FrameSyncBuffer::isComplete(const PendingSet &set) const
+{
+    if (m_expectedPipes.isEmpty()) {
+        return true;
+    }
+    for (int pipeId : m_expectedPipes) {
+        if (!set.frames.contains(pipeId)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+FrameSyncBuffer::FrameSet FrameSyncBuffer::takeSet(int index)
+{
+    PendingSet set = m_pending.takeAt(index);
+    m_pendingBytes -= set.bytes;
+
+    // Present in pipe order so the result does not depend on hash order
+    QList<int> pipes = set.frames.keys();
+    std::sort(pipes.begin(), pipes.end());
+    FrameSet frames;
+    for (int pipeId : pipes) {
+        frames.append(set.frames.value(pipeId));
+    }
+    return frames;
+}
+
+void FrameSyncBuffer::dropSet(int index)
+{
+    m_pendingBytes -= m_pending.at(index).bytes;
+    m_pending.removeAt(index);
+}
@@ -0,0 +1,91 @@
+#ifndef FRAMESYNCBUFFER_H
+#define FRAMESYNCBUFFER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QSet>
+
+#include "utils.h"
+
+// Groups frames of different pipes that belong to the same capture instant
+// (stereo / surround rigs). A set is released once every expected pipe has
+// contributed a frame; sets that miss the latency deadline, or that no longer
+// fit in the bounded buffer, are dropped and counted.
+class FrameSyncBuffer
+{
+public:
+    enum Mode {
+        ByFrameId = 0,     // same pic_info.frame_id
+        ByArrivalTime      // arrival within the tolerance (no capture timestamp on the wire)
+    };
+
+    struct Frame {
+        cmd_header_new_t header;
+        QByteArray body;   // must own its data
+    };
+    typedef QList<Frame> FrameSet;
+
+    FrameSyncBuffer();
+
+    void setMode(Mode mode) { m_mode = mode; }
+    Mode mode() const { return m_mode; }
+    // 0 = derive from the frame interval
+    void setToleranceMs(int ms) { m_toleranceMs = qMax(0, ms); }
+    int toleranceMs() const { return m_toleranceMs; }
+    int effectiveToleranceMs() const;
+    void setDeadlineMs(int ms) { m_deadlineMs = qMax(1, ms); }
+    int deadlineMs() const { return m_deadlineMs; }
+    void setLimits(int maxPendingSets, qint64 maxPendingBytes);
+    void setExpectedPipes(const QSet<int> &pipes) { m_expectedPipes = pipes; }
+
+    // Add a frame, returns the sets it completed (oldest first)
+    QList<FrameSet> push(const Frame &frame, qint64 nowMs);
+    // Drop sets older than the deadline
+    void expire(qint64 nowMs);
+    void clear();
+
+    int pendingSets() const { return m_pending.size(); }
+    qint64 pendingBytes() const { return m_pendingBytes; }
+    quint64 completeSets() const { return m_completeSets; }
+    quint64 incompleteSets() const { return m_incompleteSets; }
+    quint64 droppedSets() const { return m_droppedSets; }
+
+private:
+    struct PendingSet {
+        quint32 frameId;
+        qint64 firstArrivalMs;
+        QHash<int, Frame> frames;
+        qint64 bytes;
+    };
+
+    int findSet(const Frame &frame, qint64 nowMs) const;
+    bool isComplete(const PendingSet &set) const;
+    FrameSet takeSet(int index);
+    void dropSet(int index);
+    void trackArrival(int pipeId, qint64 nowMs);
+
+    // Automatic tolerance until a pipe has delivered two frames
+    static const int DefaultToleranceMs = 50;
+    static const int MaxIntervalMs = 1000;
+
+    Mode m_mode;
+    int m_toleranceMs;
+    // Smoothed frame interval per pipe, for the automatic tolerance
+    QHash<int, qint64> m_lastArrivalMs;
+    QHash<int, double> m_intervalMs;
+    int m_deadlineMs;
+    int m_maxPendingSets;
+    qint64 m_maxPendingBytes;
+    QSet<int> m_expectedPipes;
+
+    // Oldest first
+    QList<PendingSet> m_pending;
+    qint64 m_pendingBytes;
+
+    quint64 m_completeSets;
+    quint64 m_incompleteSets;   // hit the deadline or were overtaken by a newer complete set
+    quint64 m_droppedSets;      // evicted because the buffer was full
+};
+
+#endif // FRAMESYNCBUFFER_H
@@ -20,9 +20,20 @@ QImage ImageProvider::requestImage(const QString &id, QSize *size, const QSize &
     
     // Parse pipe ID from request ID
     // Format expected: "pipe<id>/<timestamp>" e.g., "pipe0/123456789"
+    // Inspector tiles: "tile/<pipe>/<level>/<x>/<y>/<timestamp>"
     QImage targetImage = m_image;
     
-    if (m_networkClient && id.startsWith("pipe")) {
+    if (m_networkClient && id.startsWith("tile/")) {
+        QStringList parts = id.split("/");
+        if (parts.size() >= 5) {
+            int pipeId = parts[1].toInt();
+            int level = parts[2].toInt();
+            int tileX = parts[3].toInt();
+            int tileY = parts[4].toInt();
+            LOG_DEBUG("Requesting tile for pipe:" << pipeId << "level:" << level << "tile:" << tileX << tileY);
+            targetImage = m_networkClient->getTileForPipe(pipeId, level, tileX, tileY);
+        }
+    } else if (m_networkClient && id.startsWith("pipe")) {
         QString pipeStr = id.split("/").first();
         if (pipeStr.startsWith("pipe")) {
             bool ok;
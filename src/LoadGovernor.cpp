@@ -0,0 +1,116 @@
+#include <QProcessEnvironment>
+
+#include "LoadGovernor.h"
+#include "Logger.h"
+
+LoadGovernor::LoadGovernor()
+    : m_maxResidentBytes(1024LL * 1024 * 1024)
+    , m_targetCpuShare(0.6)
+    , m_level(Normal)
+    , m_workNsecs(0)
+    , m_cpuShare(0.0)
+    , m_residentBytes(0)
+    , m_calmWindows(0)
+{
+    // Defaults can be overridden the same way as PLAYER_LOG
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    bool ok = false;
+    qint64 maxMb = env.value("PLAYER_MAX_MEMORY_MB").toLongLong(&ok);
+    if (ok && maxMb > 0) {
+        m_maxResidentBytes = maxMb * 1024 * 1024;
+    }
+    double cpuShare = env.value("PLAYER_CPU_SHARE").toDouble(&ok);
+    if (ok && cpuShare > 0.0) {
+        m_targetCpuShare = cpuShare;
+    }
+}
+
+void LoadGovernor::setBudget(qint64 maxResidentBytes, double targetCpuShare)
+{
+    if (maxResidentBytes > 0) {
+        m_maxResidentBytes = maxResidentBytes;
+    }
+    if (targetCpuShare > 0.0) {
+        m_targetCpuShare = targetCpuShare;
+    }
+}
+
+bool LoadGovernor::evaluate(qint64 residentBytes, qint64 elapsedNsecs)
+{
+    m_cpuShare = elapsedNsecs > 0 ? static_cast<double>(m_workNsecs) / elapsedNsecs : 0.0;
+    m_workNsecs = 0;
+    m_residentBytes = residentBytes;
+
+    const bool overCpu = m_cpuShare > m_targetCpuShare;
+    const bool overMemory = residentBytes > m_maxResidentBytes;
+    const bool calm = m_cpuShare < m_targetCpuShare * CalmFactor
+                      && residentBytes < m_maxResidentBytes * 8 / 10;
+
+    const Level oldLevel = m_level;
+    if (overCpu || overMemory) {
+        m_calmWindows = 0;
+        if (m_level < SkipFrames) {
+            m_level = static_cast<Level>(m_level + 1);
+            m_reason = overMemory
+                ? QString("memory %1 MB > %2 MB").arg(residentBytes >> 20).arg(m_maxResidentBytes >> 20)
+                : QString("CPU %1% > %2%").arg(qRound(m_cpuShare * 100)).arg(qRound(m_targetCpuShare * 100));
+        }
+    } else if (calm) {
+        if (++m_calmWindows >= CalmWindowsToRecover && m_level > Normal) {
+            m_level = static_cast<Level>(m_level - 1);
+            m_calmWindows = 0;
+            m_reason = "load back under budget";
+        }
+    } else {
+        m_calmWindows = 0;
+    }
+
+    if (m_level != oldLevel) {
+        LOG_DEBUG("LoadGovernor level" << levelName(oldLevel) << "->" << levelName(m_level) << "reason:" << m_reason);
+        return true;
+    }
+    return false;
+}
+
+QString LoadGovernor::describe() const
+{
+    QString text = QString("%1 (CPU %2%, memory %3 MB)")
+                   .arg(levelName(m_level))
+                   .arg(qRound(m_cpuShare * 100))
+                   .arg(m_residentBytes >> 20);
+    if (m_level != Normal && !m_reason.isEmpty()) {
+        text += QString(" - %1").arg(m_reason);
+    }
+    return text;
+}
+
+LoadGovernor::Action LoadGovernor::actionFor(bool focused, quint32 sequence) const
+{
+    if (focused) {
+        return ConvertFull;
+    }
+    switch (m_level) {
+    case DecimateBackground:
+        return (sequence % 2) ? SkipFrame : ConvertFull;
+    case HalfResBackground:
+        return (sequence % 2) ? SkipFrame : ConvertHalf;
+    case SkipFrames:
+        return (sequence % 4) ? SkipFrame : ConvertHalf;
+    default:
+        return ConvertFull;
+    }
+}
+
+QString LoadGovernor::levelName(Level level)
+{
+    switch (level) {
+    case DecimateBackground:
+        return "Decimate background";
+    case HalfResBackground:
+        return "Half-res background";
+    case SkipFrames:
+        return "Skip frames";
+    default:
+        return "Normal";
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef LOADGOVERNOR_H
+#define LOADGOVERNOR_H
+
+#include <QString>
+#include <QtGlobal>
+
+// Keeps the player inside a memory and CPU budget by degrading background
+// pipes in steps. The focused pipe is never degraded.
+//
+// CPU share is the fraction of wall time the GUI thread spends converting
+// frames, measured over one evaluation window.
+class LoadGovernor
+{
+public:
+    enum Level {
+        Normal = 0,
+        DecimateBackground,   // background pipes: every 2nd frame, raw buffers released
+        HalfResBackground,    // background pipes: every 2nd frame at half resolution
+        SkipFrames            // background pipes: every 4th frame at half resolution
+    };
+
+    enum Action {
+        ConvertFull,
+        ConvertHalf,
+        SkipFrame
+    };
+
+    LoadGovernor();
+
+    void setBudget(qint64 maxResidentBytes, double targetCpuShare);
+    qint64 maxResidentBytes() const { return m_maxResidentBytes; }
+    double targetCpuShare() const { return m_targetCpuShare; }
+
+    // Conversion time spent since the last evaluate()
+    void addWork(qint64 nsecs) { m_workNsecs += nsecs; }
+
+    // Close the current window, returns true when the level changed
+    bool evaluate(qint64 residentBytes, qint64 elapsedNsecs);
+
+    Level level() const { return m_level; }
+    double cpuShare() const { return m_cpuShare; }
+    qint64 residentBytes() const { return m_residentBytes; }
+    QString reason() const { return m_reason; }
+    QString describe() const;
+
+    // What to do with frame number `sequence` of a pipe
+    Action actionFor(bool focused, quint32 sequence) const;
+
+    static QString levelName(Level level);
+
+private:
+    // Step down only after this many windows well under budget
+    static const int CalmWindowsToRecover = 3;
+    static constexpr double CalmFactor = 0.6;
+
+    qint64 m_maxResidentBytes;
+    double m_targetCpuShare;
+    Level m_level;
+    qint64 m_workNsecs;
+    double m_cpuShare;
+    qint64 m_residentBytes;
+    int m_calmWindows;
+    QString m_reason;
+};
+
+#endif // LOADGOVERNOR_H
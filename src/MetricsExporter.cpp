@@ -0,0 +1,103 @@
+#include <QHostAddress>
+#include <QProcessEnvironment>
+#include <QSaveFile>
+#include <QTcpSocket>
+
+#include "MetricsExporter.h"
+#include "MetricsRegistry.h"
+#include "Logger.h"
+
+MetricsExporter::MetricsExporter(QObject *parent)
+    : QObject(parent)
+    , m_server(new QTcpServer(this))
+    , m_dumpTimer(new QTimer(this))
+{
+    connect(m_server, &QTcpServer::newConnection, this, &MetricsExporter::onNewConnection);
+    connect(m_dumpTimer, &QTimer::timeout, this, &MetricsExporter::dumpToFile);
+}
+
+void MetricsExporter::startFromEnvironment()
+{
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+
+    bool ok = false;
+    const int port = env.value("PLAYER_METRICS_PORT").toInt(&ok);
+    if (ok && port > 0 && port <= 65535) {
+        listen(static_cast<quint16>(port));
+    }
+
+    const QString path = env.value("PLAYER_METRICS_FILE");
+    if (!path.isEmpty()) {
+        int interval = env.value("PLAYER_METRICS_INTERVAL", "10").toInt(&ok);
+        setDumpFile(path, ok ? interval : 10);
+    }
+}
+
+bool MetricsExporter::listen(quint16 port)
+{
+    // Local only, scraped by an agent on the bench machine
+    if (!m_server->listen(QHostAddress::LocalHost, port)) {
+        qWarning() << "Metrics endpoint: listen on port" << port << "failed:" << m_server->errorString();
+        return false;
+    }
+    LOG_DEBUG(qPrintable(QString("Metrics endpoint on http://127.0.0.1:%1/metrics").arg(port)));
+    return true;
+}
+
+void MetricsExporter::setDumpFile(const QString &path, int intervalSeconds)
+{
+    m_dumpPath = path;
+    if (path.isEmpty()) {
+        m_dumpTimer->stop();
+        return;
+    }
+    m_dumpTimer->start(qMax(1, intervalSeconds) * 1000);
+}
+
+void MetricsExporter::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        // A scrape takes milliseconds; don't let stalled clients pile up
+        QTimer::singleShot(IdleTimeoutMs, socket, [socket]() {
+            socket->abort();
+        });
+        connect(socket, &QTcpSocket::readyRead, socket, [socket]() {
+            if (socket->bytesAvailable() > MaxRequestBytes) {
+                LOG_DEBUG("Metrics endpoint: request too large, closing");
+                socket->abort();
+                return;
+            }
+            // Wait for the end of the request headers, the path is not checked
+            QByteArray request = socket->peek(socket->bytesAvailable());
+            if (!request.contains("\r\n\r\n") && !request.contains("\n\n")) {
+                return;
+            }
+            socket->readAll();
+
+            const QByteArray body = MetricsRegistry::instance().renderPrometheus();
+            QByteArray response;
+            response += "HTTP/1.1 200 OK\r\n"
+                        "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                        "Connection: close\r\n"
+                        "Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n";
+            response += body;
+            socket->write(response);
+            socket->disconnectFromHost();
+        });
+    }
+}
+
+void MetricsExporter::dumpToFile()
+{
+    // Written atomically so a reader never sees a half written file
+    QSaveFile file(m_dumpPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        LOG_DEBUG("Metrics dump: cannot open" << m_dumpPath);
+        return;
+    }
+    file.write(MetricsRegistry::instance().renderPrometheus());
+    if (!file.commit()) {
+        LOG_DEBUG("Metrics dump: cannot write" << m_dumpPath);
+    }
+}
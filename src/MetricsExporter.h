@@ -0,0 +1,40 @@
+#ifndef METRICSEXPORTER_H
+#define METRICSEXPORTER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTimer>
+#include <QString>
+
+// Serves MetricsRegistry on a local HTTP endpoint (Prometheus scrape target)
+// and/or dumps it to a file periodically. Configured from the environment,
+// the same way PLAYER_LOG enables logging:
+//   PLAYER_METRICS_PORT=9464           serve http://127.0.0.1:9464/metrics
+//   PLAYER_METRICS_FILE=/tmp/player.prom  rewrite this file periodically
+//   PLAYER_METRICS_INTERVAL=10         file dump interval in seconds
+class MetricsExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsExporter(QObject *parent = nullptr);
+
+    void startFromEnvironment();
+    bool listen(quint16 port);
+    void setDumpFile(const QString &path, int intervalSeconds);
+
+private slots:
+    void onNewConnection();
+    void dumpToFile();
+
+private:
+    // Limits per scrape connection: request header size, lifetime
+    static const qint64 MaxRequestBytes = 8192;
+    static const int IdleTimeoutMs = 5000;
+
+    QTcpServer *m_server;
+    QTimer *m_dumpTimer;
+    QString m_dumpPath;
+};
+
+#endif // METRICSEXPORTER_H
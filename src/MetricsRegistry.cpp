@@ -0,0 +1,153 @@
+#include "MetricsRegistry.h"
+
+const qint64 MetricsRegistry::BucketBoundsUs[MetricsRegistry::BucketCount] = {
+    250, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000, 250000
+};
+
+MetricsRegistry &MetricsRegistry::instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::MetricsRegistry()
+{
+    m_bytesReceived.store(0);
+    for (PipeCounters &pipe : m_pipes) {
+        pipe.bytes.store(0);
+        pipe.frames.store(0);
+        for (std::atomic<quint64> &bucket : pipe.decodeBuckets) {
+            bucket.store(0);
+        }
+        pipe.decodeSumNs.store(0);
+        pipe.decodeCount.store(0);
+    }
+    for (std::atomic<quint64> &drop : m_drops) {
+        drop.store(0);
+    }
+    for (std::atomic<qint64> &gauge : m_gauges) {
+        gauge.store(0);
+    }
+    m_connects.store(0);
+    m_disconnects.store(0);
+    m_resyncs.store(0);
+    m_resyncSkippedBytes.store(0);
+}
+
+void MetricsRegistry::addFrame(int pipeId, qint64 bytes)
+{
+    PipeCounters &pipe = m_pipes[slotFor(pipeId)];
+    pipe.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    pipe.frames.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::observeDecode(int pipeId, qint64 nsecs)
+{
+    PipeCounters &pipe = m_pipes[slotFor(pipeId)];
+    const qint64 us = nsecs / 1000;
+    int bucket = 0;
+    while (bucket < BucketCount && us > BucketBoundsUs[bucket]) {
+        ++bucket;
+    }
+    pipe.decodeBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    pipe.decodeSumNs.fetch_add(nsecs, std::memory_order_relaxed);
+    pipe.decodeCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+QByteArray MetricsRegistry::renderPrometheus() const
+{
+    static const char *dropNames[DropReasonCount] = {
+        "governor", "sync_incomplete", "sync_evicted", "relay_slow_client", "snapshot_backlog"
+    };
+    static const char *gaugeNames[GaugeCount][2] = {
+        { "player_receive_buffer_bytes", "Bytes waiting in the receive buffers." },
+        { "player_resident_frame_bytes", "Frame bytes held by the player (governor budget)." },
+        { "player_snapshot_bytes", "Bytes held by snapshot rings and queued export jobs." },
+        { "player_snapshot_pending_jobs", "Export jobs not written yet." },
+        { "player_relay_clients", "Connected downstream relay clients." },
+        { "player_relay_max_queue_frames", "Deepest relay client queue." },
+        { "player_sync_pending_sets", "Frame sets waiting in the sync buffer." },
+        { "player_governor_level", "Load governor degradation level (0 = normal)." },
+    };
+
+    auto pipeLabel = [](int slot) {
+        return slot < MaxPipes ? QByteArray::number(slot) : QByteArray("other");
+    };
+
+    QByteArray out;
+    out.reserve(8192);
+
+    out += "# HELP player_bytes_received_total Bytes read from the camera connection.\n"
+           "# TYPE player_bytes_received_total counter\n";
+    out += "player_bytes_received_total " + QByteArray::number(m_bytesReceived.load(std::memory_order_relaxed)) + "\n";
+
+    out += "# HELP player_pipe_bytes_total Frame body bytes received per pipe.\n"
+           "# TYPE player_pipe_bytes_total counter\n";
+    for (int slot = 0; slot <= MaxPipes; ++slot) {
+        if (m_pipes[slot].frames.load(std::memory_order_relaxed) > 0) {
+            out += "player_pipe_bytes_total{pipe=\"" + pipeLabel(slot) + "\"} "
+                   + QByteArray::number(m_pipes[slot].bytes.load(std::memory_order_relaxed)) + "\n";
+        }
+    }
+
+    out += "# HELP player_pipe_frames_total Frames received per pipe.\n"
+           "# TYPE player_pipe_frames_total counter\n";
+    for (int slot = 0; slot <= MaxPipes; ++slot) {
+        const quint64 frames = m_pipes[slot].frames.load(std::memory_order_relaxed);
+        if (frames > 0) {
+            out += "player_pipe_frames_total{pipe=\"" + pipeLabel(slot) + "\"} " + QByteArray::number(frames) + "\n";
+        }
+    }
+
+    out += "# HELP player_decode_seconds Frame conversion time per pipe.\n"
+           "# TYPE player_decode_seconds histogram\n";
+    for (int slot = 0; slot <= MaxPipes; ++slot) {
+        const PipeCounters &pipe = m_pipes[slot];
+        const quint64 count = pipe.decodeCount.load(std::memory_order_relaxed);
+        if (count == 0) {
+            continue;
+        }
+        const QByteArray label = "pipe=\"" + pipeLabel(slot) + "\"";
+        quint64 cumulative = 0;
+        for (int bucket = 0; bucket <= BucketCount; ++bucket) {
+            cumulative += pipe.decodeBuckets[bucket].load(std::memory_order_relaxed);
+            const QByteArray le = bucket < BucketCount
+                ? QByteArray::number(BucketBoundsUs[bucket] / 1e6, 'g', 6)
+                : QByteArray("+Inf");
+            out += "player_decode_seconds_bucket{" + label + ",le=\"" + le + "\"} " + QByteArray::number(cumulative) + "\n";
+        }
+        out += "player_decode_seconds_sum{" + label + "} "
+               + QByteArray::number(pipe.decodeSumNs.load(std::memory_order_relaxed) / 1e9, 'f', 6) + "\n";
+        out += "player_decode_seconds_count{" + label + "} " + QByteArray::number(count) + "\n";
+    }
+
+    out += "# HELP player_frames_dropped_total Frames or frame sets dropped, by reason.\n"
+           "# TYPE player_frames_dropped_total counter\n";
+    for (int reason = 0; reason < DropReasonCount; ++reason) {
+        out += QByteArray("player_frames_dropped_total{reason=\"") + dropNames[reason] + "\"} "
+               + QByteArray::number(m_drops[reason].load(std::memory_order_relaxed)) + "\n";
+    }
+
+    for (int gauge = 0; gauge < GaugeCount; ++gauge) {
+        out += QByteArray("# HELP ") + gaugeNames[gauge][0] + " " + gaugeNames[gauge][1] + "\n";
+        out += QByteArray("# TYPE ") + gaugeNames[gauge][0] + " gauge\n";
+        out += QByteArray(gaugeNames[gauge][0]) + " "
+               + QByteArray::number(m_gauges[gauge].load(std::memory_order_relaxed)) + "\n";
+    }
+
+    out += "# HELP player_connects_total Connections established to the camera.\n"
+           "# TYPE player_connects_total counter\n";
+    out += "player_connects_total " + QByteArray::number(m_connects.load(std::memory_order_relaxed)) + "\n";
+    out += "# HELP player_disconnects_total Connections lost or closed.\n"
+           "# TYPE player_disconnects_total counter\n";
+    out += "player_disconnects_total " + QByteArray::number(m_disconnects.load(std::memory_order_relaxed)) + "\n";
+
+    out += "# HELP player_stream_resyncs_total Invalid headers: TCP resyncs and rejected shared-memory descriptors.\n"
+           "# TYPE player_stream_resyncs_total counter\n";
+    out += "player_stream_resyncs_total " + QByteArray::number(m_resyncs.load(std::memory_order_relaxed)) + "\n";
+    out += "# HELP player_stream_resync_skipped_bytes_total Bytes discarded because of invalid headers.\n"
+           "# TYPE player_stream_resync_skipped_bytes_total counter\n";
+    out += "player_stream_resync_skipped_bytes_total " + QByteArray::number(m_resyncSkippedBytes.load(std::memory_order_relaxed)) + "\n";
+
+    return out;
+}
@@ -0,0 +1,84 @@
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include <QByteArray>
+#include <QtGlobal>
+#include <atomic>
+
+// Process wide metrics for long running viewers / recorders.
+// Every update is a relaxed atomic add or store, no locks and no allocation,
+// so the hot path cost is the same whether anybody scrapes or not.
+// renderPrometheus() produces the Prometheus text exposition format.
+class MetricsRegistry
+{
+public:
+    // Pipe ids at or above this share the last slot (rendered as pipe="other")
+    static const int MaxPipes = 16;
+
+    enum DropReason {
+        DropGovernor = 0,      // background frame skipped by the load governor
+        DropSyncIncomplete,    // sync set missed its deadline
+        DropSyncEvicted,       // sync set evicted, buffer full
+        DropRelaySlowClient,   // relay frame dropped for a slow downstream viewer
+        DropSnapshotBacklog,   // burst frame skipped, writers behind
+        DropReasonCount
+    };
+
+    enum Gauge {
+        GaugeReceiveBufferBytes = 0,
+        GaugeResidentFrameBytes,
+        GaugeSnapshotBytes,
+        GaugeSnapshotPendingJobs,
+        GaugeRelayClients,
+        GaugeRelayMaxQueueFrames,
+        GaugeSyncPendingSets,
+        GaugeGovernorLevel,
+        GaugeCount
+    };
+
+    static MetricsRegistry &instance();
+
+    void addBytesReceived(qint64 bytes) { m_bytesReceived.fetch_add(bytes, std::memory_order_relaxed); }
+    void addFrame(int pipeId, qint64 bytes);
+    void observeDecode(int pipeId, qint64 nsecs);
+    void addDrop(DropReason reason, quint64 count = 1) { m_drops[reason].fetch_add(count, std::memory_order_relaxed); }
+    void setGauge(Gauge gauge, qint64 value) { m_gauges[gauge].store(value, std::memory_order_relaxed); }
+    void addConnect() { m_connects.fetch_add(1, std::memory_order_relaxed); }
+    void addDisconnect() { m_disconnects.fetch_add(1, std::memory_order_relaxed); }
+    void addResyncs(quint64 events, quint64 skippedBytes)
+    {
+        m_resyncs.fetch_add(events, std::memory_order_relaxed);
+        m_resyncSkippedBytes.fetch_add(skippedBytes, std::memory_order_relaxed);
+    }
+
+    QByteArray renderPrometheus() const;
+
+private:
+    MetricsRegistry();
+    Q_DISABLE_COPY(MetricsRegistry)
+
+    static int slotFor(int pipeId) { return (pipeId >= 0 && pipeId < MaxPipes) ? pipeId : MaxPipes; }
+
+    // Decode time bucket upper bounds in microseconds, plus +Inf
+    static const int BucketCount = 10;
+    static const qint64 BucketBoundsUs[BucketCount];
+
+    struct PipeCounters {
+        std::atomic<quint64> bytes;
+        std::atomic<quint64> frames;
+        std::atomic<quint64> decodeBuckets[BucketCount + 1];
+        std::atomic<quint64> decodeSumNs;
+        std::atomic<quint64> decodeCount;
+    };
+
+    std::atomic<quint64> m_bytesReceived;
+    PipeCounters m_pipes[MaxPipes + 1];
+    std::atomic<quint64> m_drops[DropReasonCount];
+    std::atomic<qint64> m_gauges[GaugeCount];
+    std::atomic<quint64> m_connects;
+    std::atomic<quint64> m_disconnects;
+    std::atomic<quint64> m_resyncs;
+    std::atomic<quint64> m_resyncSkippedBytes;
+};
+
+#endif // METRICSREGISTRY_H
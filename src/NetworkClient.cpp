@@ -4,8 +4,14 @@
 #include <QBuffer>
 #include <QImage>
 #include <QMetaObject>
+#include <QElapsedTimer>
 
 #include "NetworkClient.h"
+#include "FrameConverter.h"
+#include "ShmRingClient.h"
+#include "StreamRelay.h"
+#include "SnapshotManager.h"
+#include "MetricsRegistry.h"
 #include "Logger.h"
 
 NetworkClient::NetworkClient(QObject *parent)
@@ -14,12 +20,23 @@ NetworkClient::NetworkClient(QObject *parent)
     , m_connected(false)
     , m_statusMessage("Disconnected")
     , m_authMessage("AUTH:my_secret_token")
-    , m_receiveState(WAITING_FOR_HEADER)
-    , m_expectedBodyLength(0)
     , m_currentPipe(0)
     , m_currentFrame(0)
     , m_currentFps(0.0)
     , m_lastFrameId(-1)
+    , m_inspectPipe(-1)
+    , m_tileCache(MaxCachedTiles)
+    , m_focusedPipe(-1)
+    , m_governorTimer(new QTimer(this))
+    , m_governorSteps(0)
+    , m_shmRing(new ShmRingClient(this))
+    , m_localTransport(false)
+    , m_shmRejectedFrames(0)
+    , m_shmRejectedBytes(0)
+    , m_relay(new StreamRelay(this))
+    , m_snapshot(new SnapshotManager(this))
+    , m_syncEnabled(false)
+    , m_syncTimer(new QTimer(this))
 {
     // Connect socket signals - 修正错误信号连接
     connect(m_socket, &QTcpSocket::connected, this, &NetworkClient::onConnected);
@@ -28,6 +45,38 @@ NetworkClient::NetworkClient(QObject *parent)
     // 使用 errorOccurred 信号替代 error
     connect(m_socket, &QTcpSocket::errorOccurred, this, &NetworkClient::onError);
 
+    // Bound the socket buffer, when we fall behind TCP flow control slows the sender
+    // instead of the receive buffer growing without limit
+    m_socket->setReadBufferSize(ReadBufferSize);
+
+    // Local zero-copy transport
+    connect(m_shmRing, &ShmRingClient::connected, this, &NetworkClient::onConnected);
+    connect(m_shmRing, &ShmRingClient::disconnected, this, &NetworkClient::onDisconnected);
+    connect(m_shmRing, &ShmRingClient::frameReceived, this, &NetworkClient::onShmFrameReceived);
+    connect(m_shmRing, &ShmRingClient::frameRejected, this, [this](quint32 bodyLength) {
+        // Counted with the TCP resyncs: same failure, the frame is lost
+        m_shmRejectedFrames++;
+        m_shmRejectedBytes += bodyLength;
+        MetricsRegistry::instance().addResyncs(1, bodyLength);
+        setStatusMessage(QString("Rejected invalid frame descriptor (%1 so far)").arg(m_shmRejectedFrames));
+        emit streamHealthChanged();
+    });
+    connect(m_shmRing, &ShmRingClient::ringMapped, this, [this](const QString &name, quint32 slotCount, quint32 slotSize) {
+        setStatusMessage(QString("Shared memory ring %1: %2 slots of %3 bytes").arg(name).arg(slotCount).arg(slotSize));
+    });
+    connect(m_shmRing, &ShmRingClient::errorOccurred, this, [this](const QString &message) {
+        setStatusMessage(QString("Error: %1").arg(message));
+        setConnected(false);
+    });
+
+    connect(m_relay, &StreamRelay::statsChanged, this, &NetworkClient::relayChanged);
+
+    connect(m_syncTimer, &QTimer::timeout, this, &NetworkClient::onSyncTimer);
+
+    connect(m_governorTimer, &QTimer::timeout, this, &NetworkClient::onGovernorTimer);
+    m_governorTimer->start(GovernorIntervalMs);
+    m_governorWindow.start();
+
     memset(&m_currentHeader, 0, sizeof(m_currentHeader));
 }
 
@@ -45,6 +94,16 @@ void NetworkClient::connectToServer(const QString &ip, int port)
         return;
     }
     
+    // "unix:<path>" selects the local shared-memory transport, port is ignored
+    if (ip.startsWith("unix:")) {
+        const QString path = ip.mid(5);
+        m_localTransport = true;
+        setStatusMessage(QString("Connecting to %1...").arg(path));
+        m_shmRing->connectToPath(path);
+        return;
+    }
+
+    m_localTransport = false;
     setStatusMessage(QString("Connecting to %1:%2...").arg(ip).arg(port));
     m_socket->connectToHost(QHostAddress(ip), port);
 }
@@ -53,13 +112,18 @@ void NetworkClient::disconnectFromServer()
 {
     if (m_connected) {
         sendStopMessage();
-        m_socket->disconnectFromHost();
+        if (m_localTransport) {
+            m_shmRing->disconnectFromServer();
+        } else {
+            m_socket->disconnectFromHost();
+        }
         setStatusMessage("Disconnecting...");
     }
 }
 
 void NetworkClient::onConnected()
 {
+    MetricsRegistry::instance().addConnect();
     setConnected(true);
     setStatusMessage("Connected");
     sendStartMessage();
@@ -67,23 +131,37 @@ void NetworkClient::onConnected()
 
 void NetworkClient::onDisconnected()
 {
+    MetricsRegistry::instance().addDisconnect();
     setConnected(false);
     setStatusMessage("Disconnected");
-    m_receiveState = WAITING_FOR_HEADER;
-    m_receiveBuffer.clear();
+    m_framer.clear();
+    m_shmRejectedFrames = 0;
+    m_shmRejectedBytes = 0;
     memset(&m_currentHeader, 0, sizeof(m_currentHeader));
+    emit streamHealthChanged();
     
-    // Clear pipe data
+    // Clear pipe data, this also drops every view into the shared memory ring
     m_pipeData.clear();
     m_activePipesList.clear();
+    m_tileCache.clear();
+    setInspectPipe(-1);
+    setFocusedPipe(-1);
+    m_syncBuffer.clear();
+    m_syncMissingPipes.clear();
+    emit syncChanged();
+    emit focusedPipeChanged();
     emit activePipesChanged();
 }
 
 void NetworkClient::onReadyRead()
 {
-    // Append new data to buffer
-    m_receiveBuffer.append(m_socket->readAll());
-    processReceivedData();
+    // Append new data to buffer, at most ReadBufferSize at a time
+    while (m_socket->bytesAvailable() > 0) {
+        const QByteArray chunk = m_socket->read(ReadBufferSize);
+        MetricsRegistry::instance().addBytesReceived(chunk.size());
+        m_framer.append(chunk);
+        processReceivedData();
+    }
 }
 
 void NetworkClient::onError(QAbstractSocket::SocketError error)
@@ -127,105 +205,288 @@ void NetworkClient::sendStopMessage()
 
 void NetworkClient::processReceivedData()
 {
-    while (true) {
-        if (m_receiveState == WAITING_FOR_HEADER) {
-            // Check if we have enough data for header
-            if (m_receiveBuffer.size() < sizeof(m_currentHeader)) {
-                break; // Wait for more data
-            }
-            // Extract header
-            memcpy(&m_currentHeader, m_receiveBuffer.constData(), sizeof(m_currentHeader));
-            m_receiveBuffer.remove(0, sizeof(m_currentHeader));
+    const quint64 resyncsBefore = m_framer.resyncEvents();
+    const quint64 skippedBefore = m_framer.skippedBytes();
+
+    // Headers are validated by the framer, a frame only comes out whole
+    QByteArray body;
+    while (m_framer.next(&m_currentHeader, &body)) {
+        processHeader();
+        processMessage(body);
+        memset(&m_currentHeader, 0, sizeof(m_currentHeader));
+    }
 
-            m_width = m_currentHeader.pic_info.stride;
-            m_height = m_currentHeader.pic_info.height;
-            m_pipe = m_currentHeader.pic_info.pipe_id;
-            
-            // Extract frame information
-            m_currentPipe = m_currentHeader.pic_info.pipe_id;
-            m_currentFrame = m_currentHeader.pic_info.frame_id;
-            
-            // Initialize pipe data if new pipe
-            if (!m_pipeData.contains(m_currentPipe)) {
-                PipeData pipeData;
-                pipeData.frameId = -1;
-                pipeData.fps = 0.0;
-                pipeData.lastFrameId = -1;
-                pipeData.width = 0;
-                pipeData.height = 0;
-                m_pipeData[m_currentPipe] = pipeData;
-                
-                // Update active pipes list
-                if (!m_activePipesList.contains(m_currentPipe)) {
-                    m_activePipesList.append(m_currentPipe);
-                    emit activePipesChanged();
-                }
-            }
-            
-            // Update pipe-specific data
-            PipeData &pipeData = m_pipeData[m_currentPipe];
-            pipeData.frameId = m_currentFrame;
-            pipeData.width = m_width;
-            pipeData.height = m_height;
-            LOG_DEBUG("Updated pipe data - pipe:" << m_currentPipe << "frame:" << m_currentFrame << "size:" << m_width << "x" << m_height);
-            
-            // Calculate FPS for this pipe
-            QDateTime currentTime = QDateTime::currentDateTime();
-            if (pipeData.lastFrameId >= 0 && pipeData.lastFrameTime.isValid()) {
-                qint64 timeDiff = pipeData.lastFrameTime.msecsTo(currentTime);
-                if (timeDiff > 0) {
-                    pipeData.fps = 1000.0 / timeDiff;
-                }
+    const quint64 resyncs = m_framer.resyncEvents() - resyncsBefore;
+    const quint64 skipped = m_framer.skippedBytes() - skippedBefore;
+    if (resyncs > 0 || skipped > 0) {
+        MetricsRegistry::instance().addResyncs(resyncs, skipped);
+        if (resyncs > 0) {
+            setStatusMessage(QString("Stream out of sync, resynchronizing (%1 so far)").arg(m_framer.resyncEvents()));
+        }
+        emit streamHealthChanged();
+    }
+}
+
+void NetworkClient::onShmFrameReceived(const cmd_header_new_t &header, const QByteArray &body, quint32 slot)
+{
+    MetricsRegistry::instance().addBytesReceived(sizeof(shm_frame_desc_t) + body.size());
+    m_currentHeader = header;
+    processHeader();
+
+    const int pipeId = m_currentPipe;
+    processMessage(body);
+
+    // The body points into the ring and the producer can only reuse released slots.
+    // Holding one slot per pipe would stall a ring with no more slots than pipes, so
+    // only the inspected pipe (which needs the raw frame for tiles) keeps its slot
+    PipeData &pipeData = m_pipeData[pipeId];
+    if (!body.isEmpty() && pipeData.rawData.constData() == body.constData()) {
+        if (pipeId == m_inspectPipe && m_shmRing->slotCount() > 1) {
+            pipeData.shmSlot = slot;
+            memset(&m_currentHeader, 0, sizeof(m_currentHeader));
+            return;
+        }
+        pipeData.rawData = pipeId == m_inspectPipe ? QByteArray(body.constData(), body.size()) : QByteArray();
+    }
+    m_shmRing->releaseSlot(slot);
+    memset(&m_currentHeader, 0, sizeof(m_currentHeader));
+}
+
+void NetworkClient::processHeader()
+{
+    m_width = m_currentHeader.pic_info.stride;
+    m_height = m_currentHeader.pic_info.height;
+    m_pipe = m_currentHeader.pic_info.pipe_id;
+    
+    // Extract frame information
+    m_currentPipe = m_currentHeader.pic_info.pipe_id;
+    m_currentFrame = m_currentHeader.pic_info.frame_id;
+    
+    // Initialize pipe data if new pipe
+    if (!m_pipeData.contains(m_currentPipe)) {
+        PipeData pipeData;
+        pipeData.frameId = -1;
+        pipeData.fps = 0.0;
+        pipeData.lastFrameId = -1;
+        pipeData.width = 0;
+        pipeData.height = 0;
+        pipeData.format = 0;
+        pipeData.rawFrameId = -1;
+        pipeData.sequence = 0;
+        pipeData.skippedFrames = 0;
+        pipeData.halfResFrames = 0;
+        pipeData.shmSlot = -1;
+        pipeData.syncArrivalMs = 0;
+        m_pipeData[m_currentPipe] = pipeData;
+        
+        // Update active pipes list
+        if (!m_activePipesList.contains(m_currentPipe)) {
+            m_activePipesList.append(m_currentPipe);
+            emit activePipesChanged();
+            if (m_focusedPipe < 0 && m_activePipesList.size() == 1) {
+                emit focusedPipeChanged();
             }
-            pipeData.lastFrameTime = currentTime;
-            pipeData.lastFrameId = m_currentFrame;
-            
-            // Update current values for backward compatibility
-            m_currentFps = pipeData.fps;
-            
-            LOG_DEBUG("Emitting frameInfoChanged - pipe:" << m_currentPipe << "frame:" << pipeData.frameId << "fps:" << pipeData.fps);
-            emit frameInfoChanged();
-            
-            setStatusMessage(QString("Received header - pipe: %1, frame: %2, width: %3, height: %4, fps: %5")
-                           .arg(m_currentPipe)
-                           .arg(m_currentFrame)
-                           .arg(m_width)
-                           .arg(m_height)
-                           .arg(QString::number(m_currentFps, 'f', 1)));
+        }
+    }
+    
+    // Update pipe-specific data. In sync mode the frame arriving is not the one
+    // shown yet, presentSet() updates the pipe when its set is presented
+    PipeData &pipeData = m_pipeData[m_currentPipe];
+    if (!m_syncEnabled) {
+        updatePipeFrameInfo(pipeData, m_currentFrame, m_width, m_height);
+    }
+    
+    // Update current values for backward compatibility
+    m_currentFps = pipeData.fps;
+    
+    LOG_DEBUG("Emitting frameInfoChanged - pipe:" << m_currentPipe << "frame:" << pipeData.frameId << "fps:" << pipeData.fps);
+    emit frameInfoChanged();
+    
+    setStatusMessage(QString("Received header - pipe: %1, frame: %2, width: %3, height: %4, fps: %5")
+                   .arg(m_currentPipe)
+                   .arg(m_currentFrame)
+                   .arg(m_width)
+                   .arg(m_height)
+                   .arg(QString::number(m_currentFps, 'f', 1)));
+}
 
-            m_receiveState = WAITING_FOR_BODY;
+void NetworkClient::updatePipeFrameInfo(PipeData &pipeData, int frameId, quint32 width, quint32 height)
+{
+    pipeData.frameId = frameId;
+    pipeData.width = width;
+    pipeData.height = height;
+    LOG_DEBUG("Updated pipe data - frame:" << frameId << "size:" << width << "x" << height);
+
+    // Calculate FPS for this pipe
+    QDateTime currentTime = QDateTime::currentDateTime();
+    if (pipeData.lastFrameId >= 0 && pipeData.lastFrameTime.isValid()) {
+        qint64 timeDiff = pipeData.lastFrameTime.msecsTo(currentTime);
+        if (timeDiff > 0) {
+            pipeData.fps = 1000.0 / timeDiff;
+        }
+    }
+    pipeData.lastFrameTime = currentTime;
+    pipeData.lastFrameId = frameId;
+}
 
-            if (m_currentHeader.pic_info.format == PIX_FMT_SBGGR8) {
-                // RAW8
-                m_expectedBodyLength = m_width * m_height;
-            } else if (m_currentHeader.pic_info.format == PIX_FMT_RGB565) {
-                // RGB565
-                m_expectedBodyLength = m_width * m_height * 2;
-            } else if (m_currentHeader.pic_info.format == PIX_FMT_NV12) {
-                // NV12
-                m_expectedBodyLength = m_width * m_height * 3 / 2;
+void NetworkClient::processMessage(const QByteArray &data)
+{
+    MetricsRegistry::instance().addFrame(m_currentPipe, data.size());
+
+    // Fan out, snapshot and sync before any local degradation, they get every frame.
+    // TCP bodies are shared by reference; shared-memory views must be owned before they are kept
+    // Nothing is kept (or copied) while the relay has no clients or the snapshot is idle
+    const bool keepForSnapshot = m_snapshot->wantsFrames();
+    const bool relayFrame = m_relay->clientCount() > 0;
+    if ((relayFrame || keepForSnapshot || m_syncEnabled) && !data.isEmpty()) {
+        const QByteArray ownedBody = m_localTransport ? QByteArray(data.constData(), data.size()) : data;
+        if (relayFrame) {
+            QByteArray header(reinterpret_cast<const char*>(&m_currentHeader), sizeof(m_currentHeader));
+            m_relay->publish(header, ownedBody);
+        }
+        if (keepForSnapshot) {
+            m_snapshot->addFrame(m_currentHeader, ownedBody);
+        }
+        if (m_syncEnabled) {
+            FrameSyncBuffer::Frame frame;
+            frame.header = m_currentHeader;
+            frame.body = ownedBody;
+            m_pipeData[m_currentPipe].syncArrivalMs = m_syncClock.elapsed();
+            updateExpectedPipes();
+            const quint64 incompleteBefore = m_syncBuffer.incompleteSets();
+            const quint64 droppedBefore = m_syncBuffer.droppedSets();
+            const QList<FrameSyncBuffer::FrameSet> sets = m_syncBuffer.push(frame, m_syncClock.elapsed());
+            MetricsRegistry::instance().addDrop(MetricsRegistry::DropSyncIncomplete, m_syncBuffer.incompleteSets() - incompleteBefore);
+            MetricsRegistry::instance().addDrop(MetricsRegistry::DropSyncEvicted, m_syncBuffer.droppedSets() - droppedBefore);
+            for (const FrameSyncBuffer::FrameSet &set : sets) {
+                presentSet(set);
             }
-            
-        } else if (m_receiveState == WAITING_FOR_BODY) {
-            if (m_receiveBuffer.size() < static_cast<int>(m_expectedBodyLength)) {
-                break;
+            emit syncChanged();
+            return;
+        }
+    }
+
+    presentFrame(data);
+}
+
+void NetworkClient::presentSet(const FrameSyncBuffer::FrameSet &set)
+{
+    LOG_DEBUG("Presenting synchronized set of" << set.size() << "pipes");
+    const cmd_header_new_t savedHeader = m_currentHeader;
+
+    // All pipes of the set are updated before control returns to the event loop,
+    // so the scene graph never renders a half-updated set
+    for (const FrameSyncBuffer::Frame &frame : set) {
+        m_currentHeader = frame.header;
+        m_width = frame.header.pic_info.stride;
+        m_height = frame.header.pic_info.height;
+        m_pipe = frame.header.pic_info.pipe_id;
+        m_currentPipe = frame.header.pic_info.pipe_id;
+        m_currentFrame = frame.header.pic_info.frame_id;
+        updatePipeFrameInfo(m_pipeData[m_currentPipe], m_currentFrame, m_width, m_height);
+        presentFrame(frame.body, true);
+    }
+    emit frameInfoChanged();
+
+    m_currentHeader = savedHeader;
+    m_width = savedHeader.pic_info.stride;
+    m_height = savedHeader.pic_info.height;
+    m_pipe = savedHeader.pic_info.pipe_id;
+    m_currentPipe = savedHeader.pic_info.pipe_id;
+    m_currentFrame = savedHeader.pic_info.frame_id;
+}
+
+void NetworkClient::updateExpectedPipes()
+{
+    // Every pipe seen is expected, unless it has been silent too long; otherwise one
+    // dead pipe makes every set miss its deadline and freezes the whole display
+    const qint64 now = m_syncClock.elapsed();
+    QSet<int> expected;
+    QVariantList missing;
+    for (const QVariant &pipe : m_activePipesList) {
+        const int pipeId = pipe.toInt();
+        if (now - m_pipeData.value(pipeId).syncArrivalMs <= SyncPipeTimeoutMs) {
+            expected.insert(pipeId);
+        } else {
+            missing.append(pipeId);
+        }
+    }
+    m_syncBuffer.setExpectedPipes(expected);
+
+    if (missing != m_syncMissingPipes) {
+        m_syncMissingPipes = missing;
+        LOG_DEBUG("Sync: pipes without frames for" << SyncPipeTimeoutMs << "ms:" << missing);
+        if (!missing.isEmpty()) {
+            QStringList names;
+            for (const QVariant &pipe : missing) {
+                names.append(pipe.toString());
             }
-            
-            QByteArray body = m_receiveBuffer.left(m_expectedBodyLength);
-            m_receiveBuffer.remove(0, m_expectedBodyLength);
-            
-            processMessage(body);
-            
-            m_receiveState = WAITING_FOR_HEADER;
-            memset(&m_currentHeader, 0, sizeof(m_currentHeader));
-            m_expectedBodyLength = 0;
+            setStatusMessage(QString("Sync: no frames from pipe %1, syncing the others").arg(names.join(", ")));
         }
+        emit syncChanged();
     }
 }
 
-void NetworkClient::processMessage(const QByteArray &data)
+void NetworkClient::setSyncEnabled(bool enabled)
+{
+    if (m_syncEnabled == enabled) {
+        return;
+    }
+    m_syncEnabled = enabled;
+    m_syncBuffer.clear();
+    m_syncMissingPipes.clear();
+    if (enabled) {
+        m_syncClock.start();
+        // Every known pipe starts with a full timeout to show up
+        for (auto it = m_pipeData.begin(); it != m_pipeData.end(); ++it) {
+            it->syncArrivalMs = 0;
+        }
+        m_syncTimer->start(SyncTimerIntervalMs);
+    } else {
+        m_syncTimer->stop();
+    }
+    emit syncChanged();
+}
+
+void NetworkClient::setSyncMode(int mode)
+{
+    if (mode != m_syncBuffer.mode() && (mode == FrameSyncBuffer::ByFrameId || mode == FrameSyncBuffer::ByArrivalTime)) {
+        m_syncBuffer.setMode(static_cast<FrameSyncBuffer::Mode>(mode));
+        m_syncBuffer.clear();
+        emit syncChanged();
+    }
+}
+
+void NetworkClient::setSyncToleranceMs(int ms)
+{
+    if (ms != m_syncBuffer.toleranceMs()) {
+        m_syncBuffer.setToleranceMs(ms);
+        emit syncChanged();
+    }
+}
+
+void NetworkClient::setSyncDeadlineMs(int ms)
+{
+    if (ms != m_syncBuffer.deadlineMs()) {
+        m_syncBuffer.setDeadlineMs(ms);
+        emit syncChanged();
+    }
+}
+
+void NetworkClient::onSyncTimer()
 {
-    LOG_DEBUG("=== processMessage START ===");
+    updateExpectedPipes();
+    const quint64 incompleteBefore = m_syncBuffer.incompleteSets();
+    m_syncBuffer.expire(m_syncClock.elapsed());
+    if (m_syncBuffer.incompleteSets() != incompleteBefore) {
+        MetricsRegistry::instance().addDrop(MetricsRegistry::DropSyncIncomplete, m_syncBuffer.incompleteSets() - incompleteBefore);
+        emit syncChanged();
+    }
+}
+
+void NetworkClient::presentFrame(const QByteArray &data, bool inSet)
+{
+    LOG_DEBUG("=== presentFrame START ===");
     LOG_DEBUG("Data length:" << data.length());
     LOG_DEBUG("Width:" << m_width << "Height:" << m_height);
     
@@ -235,25 +496,66 @@ void NetworkClient::processMessage(const QByteArray &data)
     
     if (!data.isEmpty()) {
         LOG_DEBUG("Data is not empty, proceeding with conversion");
-        
-        // Convert NV12 data to RGB image and display
-        if (m_width > 0 && m_height > 0) {
+
+        // Keep the raw body for the pixel inspector, QByteArray is shared so this is not a copy
+        PipeData &rawPipeData = m_pipeData[m_currentPipe];
+        const bool focused = isFocusedPipe(m_currentPipe);
+        dropRawData(rawPipeData);
+        if (focused || m_governor.level() == LoadGovernor::Normal) {
+            rawPipeData.rawData = data;
+        }
+        // else: degraded background pipe, do not hold a second full-res buffer
+        rawPipeData.format = m_currentHeader.pic_info.format;
+        rawPipeData.rawFrameId = m_currentFrame;
+
+        LoadGovernor::Action action = m_governor.actionFor(focused, rawPipeData.sequence++);
+        if (inSet && action == LoadGovernor::SkipFrame) {
+            // A set is shown whole; background pipes of a set drop resolution instead of frames
+            action = LoadGovernor::ConvertHalf;
+        }
+
+        if (m_currentPipe == m_inspectPipe) {
+            // The inspector converts only the visible tiles, skip the full-frame conversion
+            m_tileCache.clear();
+            emit pipeImageChanged(m_currentPipe);
+            messageInfo += QString("\nInspecting: %1x%2, pipe: %3, frame: %4, tiles on demand")
+                          .arg(m_width).arg(m_height).arg(m_currentPipe).arg(m_currentFrame);
+        } else if (action == LoadGovernor::SkipFrame) {
+            rawPipeData.skippedFrames++;
+            MetricsRegistry::instance().addDrop(MetricsRegistry::DropGovernor);
+            messageInfo += QString("\nSkipped by load governor: pipe: %1, frame: %2, level: %3")
+                          .arg(m_currentPipe).arg(m_currentFrame).arg(LoadGovernor::levelName(m_governor.level()));
+        } else if (m_width > 0 && m_height > 0) {
             LOG_DEBUG("Width and height are valid, calling convertNV12ToRGB");
 
+            QElapsedTimer convertTimer;
+            convertTimer.start();
+
             QImage rgbImage;
-            if (m_currentHeader.pic_info.format == PIX_FMT_SBGGR8) {
+            if (action == LoadGovernor::ConvertHalf) {
+                // Decimated decode for background pipes under load
+                rgbImage = FrameConverter::convertRegion(data, m_currentHeader.pic_info.format, m_width, m_height,
+                                                         QRect(0, 0, m_width, m_height), 1);
+                rawPipeData.halfResFrames++;
+            } else if (m_currentHeader.pic_info.format == PIX_FMT_SBGGR8) {
                 // RAW8
                 rgbImage = convertBayerBGGR8ToRGB(data, m_width, m_height);
             } else if (m_currentHeader.pic_info.format == PIX_FMT_RGB565) {
                 // RGB565
-                QByteArray bgr565Data = data;
-                rgbImage = QImage((const uchar*)bgr565Data.constData(), m_width, m_height, QImage::Format_RGB16);
-                rgbImage = rgbImage.copy();
-                rgbImage = rgbImage.rgbSwapped();
+                if (data.size() >= static_cast<qint64>(m_width) * m_height * 2) {
+                    rgbImage = QImage((const uchar*)data.constData(), m_width, m_height, m_width * 2, QImage::Format_RGB16);
+                    rgbImage = rgbImage.copy();
+                    rgbImage = rgbImage.rgbSwapped();
+                } else {
+                    LOG_DEBUG("RGB565 data size insufficient - got:" << data.size() << "needed:" << (m_width * m_height * 2));
+                }
             } else {
                 // NV12
                 rgbImage = convertNV12ToRGB(data, m_width, m_height);
             }
+            const qint64 convertNsecs = convertTimer.nsecsElapsed();
+            m_governor.addWork(convertNsecs);
+            MetricsRegistry::instance().observeDecode(m_currentPipe, convertNsecs);
 
             LOG_DEBUG("Conversion result - isNull:" << rgbImage.isNull() 
                      << "size:" << rgbImage.size() << "format:" << rgbImage.format());
@@ -274,6 +576,9 @@ void NetworkClient::processMessage(const QByteArray &data)
                 LOG_DEBUG("Calling setCurrentImage");
                 messageInfo += QString("\nImage converted: %1x%2, pipe: %3, frame: %4, fps: %5")
                               .arg(m_width).arg(m_height).arg(m_currentPipe).arg(m_currentFrame).arg(QString::number(pipeData.fps, 'f', 1));
+                if (action == LoadGovernor::ConvertHalf) {
+                    messageInfo += QString(" (half resolution, level: %1)").arg(LoadGovernor::levelName(m_governor.level()));
+                }
                 LOG_DEBUG("setCurrentImage called successfully");
             } else {
                 messageInfo += "\nImage conversion failed";
@@ -289,12 +594,16 @@ void NetworkClient::processMessage(const QByteArray &data)
             hexPreview += QString("%1 ").arg(static_cast<unsigned char>(data[i]), 2, 16, QChar('0'));
         }
         messageInfo += QString("\nData preview: %1").arg(hexPreview);
+        messageInfo += QString("\nGovernor: %1, skipped: %2, half-res: %3")
+                      .arg(m_governor.describe())
+                      .arg(rawPipeData.skippedFrames)
+                      .arg(rawPipeData.halfResFrames);
     } else {
         LOG_DEBUG("Data is EMPTY!");
     }
     
     setReceivedData(messageInfo);
-    LOG_DEBUG("=== processMessage END ===");
+    LOG_DEBUG("=== presentFrame END ===");
 }
 
 void NetworkClient::setConnected(bool connected)
@@ -478,6 +787,223 @@ int NetworkClient::getFrameForPipe(int pipeId)
     return -1;
 }
 
+int NetworkClient::getWidthForPipe(int pipeId)
+{
+    if (m_pipeData.contains(pipeId)) {
+        return m_pipeData[pipeId].width;
+    }
+    return 0;
+}
+
+int NetworkClient::getHeightForPipe(int pipeId)
+{
+    if (m_pipeData.contains(pipeId)) {
+        return m_pipeData[pipeId].height;
+    }
+    return 0;
+}
+
+void NetworkClient::setInspectPipe(int pipeId)
+{
+    if (m_inspectPipe != pipeId) {
+        LOG_DEBUG("Inspect pipe changed from" << m_inspectPipe << "to" << pipeId);
+        // The previously inspected pipe gives its ring slot back, its next frame refills it
+        auto previous = m_pipeData.find(m_inspectPipe);
+        if (previous != m_pipeData.end() && previous->shmSlot >= 0) {
+            dropRawData(*previous);
+        }
+        m_inspectPipe = pipeId;
+        m_tileCache.clear();
+        emit inspectPipeChanged();
+    }
+}
+
+bool NetworkClient::startRelay(int port)
+{
+    if (port <= 0 || port > 65535) {
+        setStatusMessage(QString("Relay: invalid port %1").arg(port));
+        return false;
+    }
+    if (!m_relay->start(static_cast<quint16>(port))) {
+        setStatusMessage(QString("Relay: listen on port %1 failed: %2").arg(port).arg(m_relay->errorString()));
+        emit relayChanged();
+        return false;
+    }
+    setStatusMessage(QString("Relay listening on port %1").arg(port));
+    return true;
+}
+
+void NetworkClient::stopRelay()
+{
+    if (m_relay->isListening()) {
+        m_relay->stop();
+        setStatusMessage("Relay stopped");
+    }
+}
+
+bool NetworkClient::relayActive() const
+{
+    return m_relay->isListening();
+}
+
+int NetworkClient::relayClients() const
+{
+    return m_relay->clientCount();
+}
+
+quint64 NetworkClient::relayDroppedFrames() const
+{
+    return m_relay->droppedFrames();
+}
+
+void NetworkClient::setFocusedPipe(int pipeId)
+{
+    if (m_focusedPipe != pipeId) {
+        m_focusedPipe = pipeId;
+        emit focusedPipeChanged();
+    }
+}
+
+bool NetworkClient::isFocusedPipe(int pipeId) const
+{
+    // The inspected pipe always keeps full quality and its raw buffer
+    if (pipeId == m_inspectPipe) {
+        return true;
+    }
+    return pipeId == focusedPipe();
+}
+
+int NetworkClient::focusedPipe() const
+{
+    if (m_focusedPipe >= 0) {
+        return m_focusedPipe;
+    }
+    // Without a click the first pipe is the one being watched, it keeps full quality
+    return m_activePipesList.isEmpty() ? -1 : m_activePipesList.first().toInt();
+}
+
+void NetworkClient::dropRawData(PipeData &pipeData)
+{
+    pipeData.rawData = QByteArray();
+    if (pipeData.shmSlot >= 0) {
+        m_shmRing->releaseSlot(pipeData.shmSlot);
+        pipeData.shmSlot = -1;
+    }
+}
+
+QString NetworkClient::getQualityForPipe(int pipeId)
+{
+    auto it = m_pipeData.constFind(pipeId);
+    if (it == m_pipeData.constEnd() || m_governor.level() == LoadGovernor::Normal || isFocusedPipe(pipeId)) {
+        return QString();
+    }
+    if (m_syncEnabled) {
+        // Synced sets keep every frame, skipped frames are converted at half size
+        return m_governor.level() == LoadGovernor::DecimateBackground ? "FULL RATE, HALF RES 1 OF 2" : "FULL RATE, HALF RES";
+    }
+    switch (m_governor.level()) {
+    case LoadGovernor::DecimateBackground:
+        return "1/2 FPS";
+    case LoadGovernor::HalfResBackground:
+        return "1/2 FPS, HALF RES";
+    default:
+        return "1/4 FPS, HALF RES";
+    }
+}
+
+void NetworkClient::setMaxResidentMB(int megabytes)
+{
+    if (megabytes > 0 && maxResidentMB() != megabytes) {
+        m_governor.setBudget(static_cast<qint64>(megabytes) * 1024 * 1024, 0.0);
+        emit governorChanged();
+    }
+}
+
+void NetworkClient::setTargetCpuShare(double share)
+{
+    if (share > 0.0 && !qFuzzyCompare(targetCpuShare(), share)) {
+        m_governor.setBudget(0, share);
+        emit governorChanged();
+    }
+}
+
+qint64 NetworkClient::residentFrameBytes() const
+{
+    qint64 bytes = m_framer.bufferedBytes() + m_socket->bytesAvailable() + m_snapshot->residentBytes()
+                   + m_syncBuffer.pendingBytes();
+    for (auto it = m_pipeData.constBegin(); it != m_pipeData.constEnd(); ++it) {
+        bytes += it->image.sizeInBytes() + it->rawData.size();
+    }
+    return bytes;
+}
+
+void NetworkClient::onGovernorTimer()
+{
+    const qint64 elapsed = m_governorWindow.nsecsElapsed();
+    m_governorWindow.restart();
+
+    const qint64 resident = residentFrameBytes();
+    const bool levelChanged = m_governor.evaluate(resident, elapsed);
+
+    // Gauges are sampled once per governor window, counters are updated in place
+    MetricsRegistry &metrics = MetricsRegistry::instance();
+    metrics.setGauge(MetricsRegistry::GaugeReceiveBufferBytes, m_framer.bufferedBytes() + m_socket->bytesAvailable());
+    metrics.setGauge(MetricsRegistry::GaugeResidentFrameBytes, resident);
+    metrics.setGauge(MetricsRegistry::GaugeSnapshotBytes, m_snapshot->residentBytes());
+    metrics.setGauge(MetricsRegistry::GaugeSnapshotPendingJobs, m_snapshot->pendingJobs());
+    metrics.setGauge(MetricsRegistry::GaugeRelayClients, m_relay->clientCount());
+    metrics.setGauge(MetricsRegistry::GaugeRelayMaxQueueFrames, m_relay->maxQueueDepth());
+    metrics.setGauge(MetricsRegistry::GaugeSyncPendingSets, m_syncBuffer.pendingSets());
+    metrics.setGauge(MetricsRegistry::GaugeGovernorLevel, m_governor.level());
+
+    if (levelChanged) {
+        m_governorSteps++;
+        LOG_DEBUG("Governor step" << m_governorSteps << ":" << m_governor.describe());
+        if (m_governor.level() != LoadGovernor::Normal) {
+            // Background pipes no longer need their raw buffers
+            for (auto it = m_pipeData.begin(); it != m_pipeData.end(); ++it) {
+                if (!isFocusedPipe(it.key())) {
+                    dropRawData(*it);
+                }
+            }
+        }
+    }
+    emit governorChanged();
+}
+
+QImage NetworkClient::getTileForPipe(int pipeId, int level, int tileX, int tileY)
+{
+    auto it = m_pipeData.constFind(pipeId);
+    if (it == m_pipeData.constEnd() || it->rawData.isEmpty() || tileX < 0 || tileY < 0) {
+        return QImage();
+    }
+    level = qBound(0, level, static_cast<int>(MaxTileLevel));
+
+    // Tiles of the current frame only; the cache is cleared whenever a new frame arrives
+    const QString key = QString("%1/%2/%3/%4/%5").arg(pipeId).arg(it->rawFrameId).arg(level).arg(tileX).arg(tileY);
+    if (QImage *cached = m_tileCache.object(key)) {
+        return *cached;
+    }
+
+    const int span = TileSize << level;
+    QImage tile = FrameConverter::convertRegion(it->rawData, it->format, it->width, it->height,
+                                                QRect(tileX * span, tileY * span, span, span), level);
+    LOG_DEBUG("Converted tile" << key << "size:" << tile.size());
+    if (!tile.isNull()) {
+        m_tileCache.insert(key, new QImage(tile));
+    }
+    return tile;
+}
+
+QVariantMap NetworkClient::peekPixel(int pipeId, int x, int y)
+{
+    auto it = m_pipeData.constFind(pipeId);
+    if (it == m_pipeData.constEnd()) {
+        return QVariantMap();
+    }
+    return FrameConverter::pixelAt(it->rawData, it->format, it->width, it->height, x, y);
+}
+
 double NetworkClient::getFpsForPipe(int pipeId)
 {
     LOG_DEBUG("getFpsForPipe called for pipe:" << pipeId);
@@ -9,9 +9,19 @@
 #include <QImage>
 #include <QDateTime>
 #include <QHash>
+#include <QCache>
+#include <QVariantMap>
+#include <QElapsedTimer>
 #include <opencv2/opencv.hpp>
 
 #include "utils.h"
+#include "LoadGovernor.h"
+#include "FrameSyncBuffer.h"
+#include "StreamFramer.h"
+
+class ShmRingClient;
+class StreamRelay;
+class SnapshotManager;
 
 class NetworkClient : public QObject
 {
@@ -26,6 +36,30 @@ class NetworkClient : public QObject
     Q_PROPERTY(int currentFrame READ currentFrame NOTIFY frameInfoChanged)
     Q_PROPERTY(double currentFps READ currentFps NOTIFY frameInfoChanged)
     Q_PROPERTY(QVariantList activePipes READ activePipes NOTIFY activePipesChanged)
+    Q_PROPERTY(int inspectPipe READ inspectPipe WRITE setInspectPipe NOTIFY inspectPipeChanged)
+    Q_PROPERTY(int tileSize READ tileSize CONSTANT)
+    Q_PROPERTY(int focusedPipe READ focusedPipe WRITE setFocusedPipe NOTIFY focusedPipeChanged)
+    Q_PROPERTY(int governorLevel READ governorLevel NOTIFY governorChanged)
+    Q_PROPERTY(QString governorStatus READ governorStatus NOTIFY governorChanged)
+    Q_PROPERTY(int governorSteps READ governorSteps NOTIFY governorChanged)
+    Q_PROPERTY(int maxResidentMB READ maxResidentMB WRITE setMaxResidentMB NOTIFY governorChanged)
+    Q_PROPERTY(double targetCpuShare READ targetCpuShare WRITE setTargetCpuShare NOTIFY governorChanged)
+    Q_PROPERTY(bool relayActive READ relayActive NOTIFY relayChanged)
+    Q_PROPERTY(int relayClients READ relayClients NOTIFY relayChanged)
+    Q_PROPERTY(quint64 relayDroppedFrames READ relayDroppedFrames NOTIFY relayChanged)
+    Q_PROPERTY(bool syncEnabled READ syncEnabled WRITE setSyncEnabled NOTIFY syncChanged)
+    Q_PROPERTY(int syncMode READ syncMode WRITE setSyncMode NOTIFY syncChanged)
+    Q_PROPERTY(int syncToleranceMs READ syncToleranceMs WRITE setSyncToleranceMs NOTIFY syncChanged)
+    Q_PROPERTY(int syncEffectiveToleranceMs READ syncEffectiveToleranceMs NOTIFY syncChanged)
+    Q_PROPERTY(int syncDeadlineMs READ syncDeadlineMs WRITE setSyncDeadlineMs NOTIFY syncChanged)
+    Q_PROPERTY(int syncPendingSets READ syncPendingSets NOTIFY syncChanged)
+    Q_PROPERTY(quint64 syncCompleteSets READ syncCompleteSets NOTIFY syncChanged)
+    Q_PROPERTY(quint64 syncIncompleteSets READ syncIncompleteSets NOTIFY syncChanged)
+    Q_PROPERTY(quint64 syncDroppedSets READ syncDroppedSets NOTIFY syncChanged)
+    Q_PROPERTY(QVariantList syncMissingPipes READ syncMissingPipes NOTIFY syncChanged)
+    Q_PROPERTY(bool streamInSync READ streamInSync NOTIFY streamHealthChanged)
+    Q_PROPERTY(quint64 streamResyncs READ streamResyncs NOTIFY streamHealthChanged)
+    Q_PROPERTY(quint64 streamSkippedBytes READ streamSkippedBytes NOTIFY streamHealthChanged)
 
 public:
     explicit NetworkClient(QObject *parent = nullptr);
@@ -41,14 +75,60 @@ public:
     int currentFrame() const { return m_currentFrame; }
     double currentFps() const { return m_currentFps; }
     QVariantList activePipes() const { return m_activePipesList; }
+    int inspectPipe() const { return m_inspectPipe; }
+    void setInspectPipe(int pipeId);
+    int tileSize() const { return TileSize; }
+    // The clicked pipe, or the first active pipe when none was clicked
+    int focusedPipe() const;
+    void setFocusedPipe(int pipeId);
+    int governorLevel() const { return m_governor.level(); }
+    QString governorStatus() const { return m_governor.describe(); }
+    int governorSteps() const { return m_governorSteps; }
+    int maxResidentMB() const { return static_cast<int>(m_governor.maxResidentBytes() >> 20); }
+    void setMaxResidentMB(int megabytes);
+    double targetCpuShare() const { return m_governor.targetCpuShare(); }
+    void setTargetCpuShare(double share);
+    bool relayActive() const;
+    int relayClients() const;
+    quint64 relayDroppedFrames() const;
+    SnapshotManager *snapshotManager() const { return m_snapshot; }
+    bool syncEnabled() const { return m_syncEnabled; }
+    void setSyncEnabled(bool enabled);
+    int syncMode() const { return m_syncBuffer.mode(); }
+    void setSyncMode(int mode);
+    int syncToleranceMs() const { return m_syncBuffer.toleranceMs(); }
+    void setSyncToleranceMs(int ms);
+    int syncEffectiveToleranceMs() const { return m_syncBuffer.effectiveToleranceMs(); }
+    int syncDeadlineMs() const { return m_syncBuffer.deadlineMs(); }
+    void setSyncDeadlineMs(int ms);
+    int syncPendingSets() const { return m_syncBuffer.pendingSets(); }
+    quint64 syncCompleteSets() const { return m_syncBuffer.completeSets(); }
+    quint64 syncIncompleteSets() const { return m_syncBuffer.incompleteSets(); }
+    quint64 syncDroppedSets() const { return m_syncBuffer.droppedSets(); }
+    // Pipes left out of sync sets because they went silent
+    QVariantList syncMissingPipes() const { return m_syncMissingPipes; }
+    bool streamInSync() const { return m_framer.inSync(); }
+    // TCP resyncs plus rejected shared-memory descriptors
+    quint64 streamResyncs() const { return m_framer.resyncEvents() + m_shmRejectedFrames; }
+    quint64 streamSkippedBytes() const { return m_framer.skippedBytes() + m_shmRejectedBytes; }
     
     Q_INVOKABLE QImage getImageForPipe(int pipeId);
     Q_INVOKABLE int getFrameForPipe(int pipeId);
     Q_INVOKABLE double getFpsForPipe(int pipeId);
+    Q_INVOKABLE int getWidthForPipe(int pipeId);
+    Q_INVOKABLE int getHeightForPipe(int pipeId);
+    // Pixel inspector: tiles are converted on demand from the raw frame
+    Q_INVOKABLE QImage getTileForPipe(int pipeId, int level, int tileX, int tileY);
+    Q_INVOKABLE QVariantMap peekPixel(int pipeId, int x, int y);
+    // Empty when the pipe is shown at full quality, otherwise what the governor did to it
+    Q_INVOKABLE QString getQualityForPipe(int pipeId);
 
 public slots:
     void connectToServer(const QString &ip, int port);
     void disconnectFromServer();
+    // Re-serve the received stream to downstream viewers on a local port
+    bool startRelay(int port);
+    void stopRelay();
 
 signals:
     void connectedChanged();
@@ -58,12 +138,21 @@ signals:
     void frameInfoChanged();
     void activePipesChanged();
     void pipeImageChanged(int pipeId);
+    void inspectPipeChanged();
+    void focusedPipeChanged();
+    void governorChanged();
+    void relayChanged();
+    void syncChanged();
+    void streamHealthChanged();
 
 private slots:
     void onConnected();
     void onDisconnected();
     void onReadyRead();
     void onError(QAbstractSocket::SocketError error);
+    void onGovernorTimer();
+    void onShmFrameReceived(const cmd_header_new_t &header, const QByteArray &body, quint32 slot);
+    void onSyncTimer();
 
 private:
     void setConnected(bool connected);
@@ -73,10 +162,16 @@ private:
     void sendStartMessage();
     void sendStopMessage();
     void processReceivedData();
+    void processHeader();
     void processMessage(const QByteArray &data);
+    void presentFrame(const QByteArray &data, bool inSet = false);
+    void presentSet(const FrameSyncBuffer::FrameSet &set);
+    void updateExpectedPipes();
     QImage convertNV12ToRGB(const QByteArray &nv12Data, int width, int height);
     QImage convertBayerBGGR8ToRGB(const QByteArray &bayerData, int width, int height);
     QImage addOverlayToImage(const QImage &image, int pipe, int frame, double fps);
+    bool isFocusedPipe(int pipeId) const;
+    qint64 residentFrameBytes() const;
 
     QTcpSocket *m_socket;
     bool m_connected;
@@ -86,18 +181,12 @@ private:
     QImage m_currentImage;
     
     // Protocol state
-    enum ReceiveState {
-        WAITING_FOR_HEADER,
-        WAITING_FOR_BODY
-    };
-    
-    ReceiveState m_receiveState;
     cmd_header_new_t m_currentHeader;
     quint32 m_width;
     quint32 m_height;
     quint32 m_pipe;
-    QByteArray m_receiveBuffer;
-    quint32 m_expectedBodyLength;
+    // Validated framing of the TCP stream, resyncs after garbage
+    StreamFramer m_framer;
     
     // Frame tracking for FPS calculation
     int m_currentPipe;
@@ -115,10 +204,65 @@ private:
         int lastFrameId;
         quint32 width;
         quint32 height;
+        // Last complete frame body as received, shared with the receive path (no copy)
+        QByteArray rawData;
+        quint32 format;
+        int rawFrameId;
+        // Load governor bookkeeping
+        quint32 sequence;
+        quint64 skippedFrames;
+        quint64 halfResFrames;
+        // Shared memory slot backing rawData on the local transport, -1 if none.
+        // Only the inspected pipe holds one, see onShmFrameReceived()
+        int shmSlot;
+        // Last arrival on the sync clock
+        qint64 syncArrivalMs;
     };
     
     QHash<int, PipeData> m_pipeData;
     QVariantList m_activePipesList;
+    // Clear rawData and give its shared memory slot back, if any
+    void dropRawData(PipeData &pipeData);
+    // Frame id, size and FPS of the frame the pipe shows
+    void updatePipeFrameInfo(PipeData &pipeData, int frameId, quint32 width, quint32 height);
+
+    // Pixel inspector
+    static const int TileSize = 256;
+    static const int MaxTileLevel = 5;
+    static const int MaxCachedTiles = 64;
+    int m_inspectPipe;
+    QCache<QString, QImage> m_tileCache;
+
+    // Memory / CPU budget
+    static const qint64 ReadBufferSize = 4 * 1024 * 1024;
+    static const int GovernorIntervalMs = 1000;
+    int m_focusedPipe;
+    LoadGovernor m_governor;
+    QTimer *m_governorTimer;
+    QElapsedTimer m_governorWindow;
+    int m_governorSteps;
+
+    // Local transport (unix:<path>)
+    ShmRingClient *m_shmRing;
+    bool m_localTransport;
+    quint64 m_shmRejectedFrames;
+    quint64 m_shmRejectedBytes;
+
+    // Fan-out to downstream viewers
+    StreamRelay *m_relay;
+
+    // Burst snapshot / export
+    SnapshotManager *m_snapshot;
+
+    // Multi-pipe synchronization
+    static const int SyncTimerIntervalMs = 10;
+    // A pipe silent this long no longer holds up every set
+    static const int SyncPipeTimeoutMs = 1000;
+    bool m_syncEnabled;
+    FrameSyncBuffer m_syncBuffer;
+    QTimer *m_syncTimer;
+    QElapsedTimer m_syncClock;
+    QVariantList m_syncMissingPipes;
 };
 
 #endif // NETWORKCLIENT_H
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include "ShmRingClient.h"
+#include "StreamFramer.h"
+#include "Logger.h"
+
+ShmRingClient::ShmRingClient(QObject *parent)
+    : QObject(parent)
+    , m_socket(new QLocalSocket(this))
+    , m_ring(nullptr)
+    , m_ringSize(0)
+    , m_slotCount(0)
+    , m_slotSize(0)
+{
+    connect(m_socket, &QLocalSocket::connected, this, &ShmRingClient::connected);
+    connect(m_socket, &QLocalSocket::disconnected, this, &ShmRingClient::onDisconnected);
+    connect(m_socket, &QLocalSocket::readyRead, this, &ShmRingClient::onReadyRead);
+    connect(m_socket, &QLocalSocket::errorOccurred, this, &ShmRingClient::onError);
+}
+
+ShmRingClient::~ShmRingClient()
+{
+    m_socket->disconnect(this);
+    m_socket->abort();
+    unmapRing();
+}
+
+void ShmRingClient::connectToPath(const QString &path)
+{
+    m_receiveBuffer.clear();
+    unmapRing();
+    m_socket->connectToServer(path);
+}
+
+void ShmRingClient::disconnectFromServer()
+{
+    m_socket->disconnectFromServer();
+}
+
+void ShmRingClient::releaseSlot(quint32 slot)
+{
+    if (m_socket->state() != QLocalSocket::ConnectedState) {
+        return;
+    }
+    shm_release_t release;
+    release.magic = SHM_RELEASE_MAGIC;
+    release.slot = slot;
+    m_socket->write(reinterpret_cast<const char*>(&release), sizeof(release));
+}
+
+void ShmRingClient::onReadyRead()
+{
+    m_receiveBuffer.append(m_socket->readAll());
+
+    // Ring description first, then fixed size frame descriptors
+    if (!m_ring) {
+        if (m_receiveBuffer.size() < static_cast<int>(sizeof(shm_ring_info_t))) {
+            return;
+        }
+        shm_ring_info_t info;
+        memcpy(&info, m_receiveBuffer.constData(), sizeof(info));
+        m_receiveBuffer.remove(0, sizeof(info));
+        if (!mapRing(info)) {
+            m_socket->abort();
+            return;
+        }
+    }
+
+    int offset = 0;
+    while (m_receiveBuffer.size() - offset >= static_cast<int>(sizeof(shm_frame_desc_t))) {
+        shm_frame_desc_t desc;
+        memcpy(&desc, m_receiveBuffer.constData() + offset, sizeof(desc));
+        offset += sizeof(desc);
+
+        if (desc.magic != SHM_FRAME_MAGIC || desc.slot >= m_slotCount || desc.body_len > m_slotSize) {
+            LOG_DEBUG("ShmRingClient: bad frame descriptor - magic:" << Qt::hex << desc.magic << Qt::dec
+                      << "slot:" << desc.slot << "len:" << desc.body_len);
+            emit errorOccurred("Invalid frame descriptor on local transport");
+            m_socket->abort();
+            return;
+        }
+
+        // Same header checks as the TCP path, and the body must be exactly the frame size;
+        // framing is intact here, so just hand the slot back and skip the frame
+        if (StreamFramer::validateHeader(desc.header) != desc.body_len) {
+            LOG_DEBUG("ShmRingClient: rejected frame - slot:" << desc.slot << "len:" << desc.body_len
+                      << "format:" << desc.header.pic_info.format << "size:" << desc.header.pic_info.stride
+                      << "x" << desc.header.pic_info.height);
+            releaseSlot(desc.slot);
+            emit frameRejected(desc.body_len);
+            continue;
+        }
+
+        const char *body = reinterpret_cast<const char*>(m_ring) + static_cast<qint64>(desc.slot) * m_slotSize;
+        emit frameReceived(desc.header, QByteArray::fromRawData(body, desc.body_len), desc.slot);
+    }
+    m_receiveBuffer.remove(0, offset);
+}
+
+void ShmRingClient::onDisconnected()
+{
+    // Receivers drop their views into the ring before it goes away
+    emit disconnected();
+    m_receiveBuffer.clear();
+    unmapRing();
+}
+
+void ShmRingClient::onError(QLocalSocket::LocalSocketError error)
+{
+    Q_UNUSED(error)
+    emit errorOccurred(m_socket->errorString());
+}
+
+bool ShmRingClient::mapRing(const shm_ring_info_t &info)
+{
+    if (info.magic != SHM_RING_MAGIC || info.slot_count == 0 || info.slot_size == 0) {
+        emit errorOccurred("Invalid shared memory ring description");
+        return false;
+    }
+
+    char name[sizeof(info.name) + 1];
+    memcpy(name, info.name, sizeof(info.name));
+    name[sizeof(info.name)] = '\0';
+
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        emit errorOccurred(QString("shm_open %1 failed: %2").arg(name).arg(strerror(errno)));
+        return false;
+    }
+
+    const qint64 size = static_cast<qint64>(info.slot_count) * info.slot_size;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < size) {
+        ::close(fd);
+        emit errorOccurred(QString("Shared memory %1 is smaller than %2 slots of %3 bytes")
+                           .arg(name).arg(info.slot_count).arg(info.slot_size));
+        return false;
+    }
+
+    void *ring = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (ring == MAP_FAILED) {
+        emit errorOccurred(QString("mmap %1 failed: %2").arg(name).arg(strerror(errno)));
+        return false;
+    }
+
+    m_ring = static_cast<uchar*>(ring);
+    m_ringSize = size;
+    m_slotCount = info.slot_count;
+    m_slotSize = info.slot_size;
+    LOG_DEBUG("ShmRingClient mapped" << name << "slots:" << m_slotCount << "slot size:" << m_slotSize);
+    emit ringMapped(QString::fromLatin1(name), m_slotCount, m_slotSize);
+    return true;
+}
+
+void ShmRingClient::unmapRing()
+{
+    if (m_ring) {
+        munmap(m_ring, m_ringSize);
+        m_ring = nullptr;
+        m_ringSize = 0;
+        m_slotCount = 0;
+        m_slotSize = 0;
+    }
+}
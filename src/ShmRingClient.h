@@ -0,0 +1,57 @@
+#ifndef SHMRINGCLIENT_H
+#define SHMRINGCLIENT_H
+
+#include <QObject>
+#include <QLocalSocket>
+#include <QByteArray>
+
+#include "utils.h"
+
+// Zero-copy local transport: frame descriptors arrive over a Unix domain
+// socket, the pixels stay in a POSIX shared-memory ring owned by the camera
+// service. Bodies are handed out as QByteArray::fromRawData() views into the
+// ring, they stay valid until releaseSlot() is called for their slot.
+class ShmRingClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ShmRingClient(QObject *parent = nullptr);
+    ~ShmRingClient();
+
+    void connectToPath(const QString &path);
+    void disconnectFromServer();
+    bool isConnected() const { return m_socket->state() == QLocalSocket::ConnectedState; }
+    QString errorString() const { return m_socket->errorString(); }
+    quint32 slotCount() const { return m_slotCount; }
+
+    // Hand a slot back to the producer, the body must not be read afterwards
+    void releaseSlot(quint32 slot);
+
+signals:
+    void connected();
+    void disconnected();
+    void ringMapped(const QString &name, quint32 slotCount, quint32 slotSize);
+    void frameReceived(const cmd_header_new_t &header, const QByteArray &body, quint32 slot);
+    // Descriptor failed header validation, its slot was released
+    void frameRejected(quint32 bodyLength);
+    void errorOccurred(const QString &message);
+
+private slots:
+    void onReadyRead();
+    void onDisconnected();
+    void onError(QLocalSocket::LocalSocketError error);
+
+private:
+    bool mapRing(const shm_ring_info_t &info);
+    void unmapRing();
+
+    QLocalSocket *m_socket;
+    QByteArray m_receiveBuffer;
+    uchar *m_ring;
+    qint64 m_ringSize;
+    quint32 m_slotCount;
+    quint32 m_slotSize;
+};
+
+#endif // SHMRINGCLIENT_H
@@ -0,0 +1,429 @@
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QStandardPaths>
+#include <QRunnable>
+#include <QThread>
+#include <QtEndian>
+
+#include "SnapshotManager.h"
+#include "FrameConverter.h"
+#include "MetricsRegistry.h"
+#include "Logger.h"
+
+// One frame to write. Jobs removed by QThreadPool::clear() are deleted
+// without running, their accounting is undone in the destructor
+class SnapshotManager::WriteJob : public QRunnable
+{
+public:
+    WriteJob(SnapshotManager *manager, const RawFrame &frame, Format format, const QString &directory)
+        : m_manager(manager), m_frame(frame), m_format(format), m_directory(directory), m_ran(false)
+    {
+    }
+
+    ~WriteJob() override
+    {
+        if (!m_ran) {
+            m_manager->jobDiscarded(m_frame.body.size());
+        }
+    }
+
+    void run() override
+    {
+        m_ran = true;
+        const bool ok = SnapshotManager::writeFrame(m_frame, m_format, m_directory);
+        m_manager->jobFinished(m_frame.body.size(), ok);
+    }
+
+private:
+    SnapshotManager *m_manager;
+    RawFrame m_frame;
+    Format m_format;
+    QString m_directory;
+    bool m_ran;
+};
+
+SnapshotManager::SnapshotManager(QObject *parent)
+    : QObject(parent)
+    , m_preTriggerFrames(0)
+    , m_ringBytes(0)
+    , m_format(Png)
+    , m_captureRemaining(0)
+    , m_skippedFrames(0)
+    , m_jobsTotal(0)
+    , m_jobsDone(0)
+    , m_jobsFailed(0)
+    , m_pendingBytes(0)
+{
+    m_exportDirectory = QStandardPaths::writableLocation(QStandardPaths::PicturesLocation) + "/vs_camplayer";
+
+    // Leave a core for the GUI thread so live display keeps its frame rate
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+    m_pool.setThreadPriority(QThread::LowPriority);
+}
+
+SnapshotManager::~SnapshotManager()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void SnapshotManager::setExportDirectory(const QString &directory)
+{
+    if (m_exportDirectory != directory) {
+        m_exportDirectory = directory;
+        emit exportDirectoryChanged();
+    }
+}
+
+void SnapshotManager::setPreTriggerFrames(int frames)
+{
+    frames = qMax(0, frames);
+    if (m_preTriggerFrames == frames) {
+        return;
+    }
+    m_preTriggerFrames = frames;
+    for (auto it = m_rings.begin(); it != m_rings.end(); ++it) {
+        while (it->size() > m_preTriggerFrames) {
+            m_ringBytes -= it->dequeue().body.size();
+        }
+    }
+    emit preTriggerFramesChanged();
+}
+
+double SnapshotManager::progress() const
+{
+    const int total = m_jobsTotal.load();
+    return total > 0 ? static_cast<double>(m_jobsDone.load()) / total : 0.0;
+}
+
+QString SnapshotManager::status() const
+{
+    const int total = m_jobsTotal.load();
+    if (total == 0) {
+        return QString("Idle");
+    }
+    QString text = QString("%1/%2 written").arg(m_jobsDone.load()).arg(total);
+    if (m_jobsFailed.load() > 0) {
+        text += QString(", %1 failed").arg(m_jobsFailed.load());
+    }
+    if (m_skippedFrames > 0) {
+        text += QString(", %1 skipped").arg(m_skippedFrames);
+    }
+    if (m_captureRemaining > 0) {
+        text += QString(", capturing %1 more").arg(m_captureRemaining);
+    }
+    if (!m_burstDirectory.isEmpty()) {
+        text += QString(" -> %1").arg(m_burstDirectory);
+    }
+    return text;
+}
+
+void SnapshotManager::addFrame(const cmd_header_new_t &header, const QByteArray &body)
+{
+    if (body.isEmpty()) {
+        return;
+    }
+
+    RawFrame frame;
+    frame.header = header;
+    frame.body = body;
+
+    if (m_captureRemaining > 0) {
+        m_captureRemaining--;
+        submit(frame);
+        if (m_captureRemaining == 0) {
+            emit progressChanged();
+        }
+    }
+
+    if (m_preTriggerFrames > 0) {
+        QQueue<RawFrame> &ring = m_rings[header.pic_info.pipe_id];
+        ring.enqueue(frame);
+        m_ringBytes += body.size();
+        while (ring.size() > m_preTriggerFrames) {
+            m_ringBytes -= ring.dequeue().body.size();
+        }
+    }
+}
+
+bool SnapshotManager::exportLast(const QString &format)
+{
+    Format parsed;
+    if (!parseFormat(format, &parsed)) {
+        return false;
+    }
+    m_format = parsed;
+    m_burstDirectory = newBurstDirectory();
+    if (m_burstDirectory.isEmpty()) {
+        return false;
+    }
+
+    for (auto it = m_rings.constBegin(); it != m_rings.constEnd(); ++it) {
+        for (const RawFrame &frame : it.value()) {
+            submit(frame);
+        }
+    }
+    emit progressChanged();
+    return true;
+}
+
+bool SnapshotManager::captureNext(int count, const QString &format)
+{
+    Format parsed;
+    if (count <= 0 || !parseFormat(format, &parsed)) {
+        return false;
+    }
+    m_format = parsed;
+    m_burstDirectory = newBurstDirectory();
+    if (m_burstDirectory.isEmpty()) {
+        return false;
+    }
+    m_captureRemaining = count;
+    emit progressChanged();
+    return true;
+}
+
+void SnapshotManager::cancelCapture()
+{
+    m_captureRemaining = 0;
+    // Queued jobs are discarded and uncounted, jobs already writing finish
+    m_pool.clear();
+    emit progressChanged();
+}
+
+bool SnapshotManager::parseFormat(const QString &name, Format *format)
+{
+    const QString lower = name.toLower();
+    if (lower == "png") {
+        *format = Png;
+    } else if (lower == "tiff" || lower == "tif") {
+        *format = Tiff;
+    } else if (lower == "bin" || lower == "raw") {
+        *format = RawBin;
+    } else if (lower == "dng") {
+        *format = BayerTiff16;
+    } else {
+        LOG_DEBUG("SnapshotManager: unknown export format" << name);
+        return false;
+    }
+    return true;
+}
+
+QString SnapshotManager::newBurstDirectory()
+{
+    // Start counting from zero unless a previous burst is still being written
+    if (!busy()) {
+        m_jobsTotal = 0;
+        m_jobsDone = 0;
+        m_jobsFailed = 0;
+        m_skippedFrames = 0;
+    }
+
+    const QString path = QString("%1/burst_%2").arg(m_exportDirectory)
+                         .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss_zzz"));
+    if (!QDir().mkpath(path)) {
+        LOG_DEBUG("SnapshotManager: cannot create" << path);
+        return QString();
+    }
+    return path;
+}
+
+void SnapshotManager::submit(const RawFrame &frame)
+{
+    const qint64 bytes = frame.body.size();
+    if (m_pendingBytes.load() + bytes > MaxPendingBytes) {
+        // Writers are behind, drop rather than stall the receive path
+        m_skippedFrames++;
+        MetricsRegistry::instance().addDrop(MetricsRegistry::DropSnapshotBacklog);
+        return;
+    }
+
+    m_pendingBytes += bytes;
+    m_jobsTotal++;
+
+    m_pool.start(new WriteJob(this, frame, m_format, m_burstDirectory));
+}
+
+void SnapshotManager::jobFinished(qint64 bytes, bool ok)
+{
+    m_pendingBytes -= bytes;
+    if (!ok) {
+        m_jobsFailed++;
+    }
+    m_jobsDone++;
+    QMetaObject::invokeMethod(this, [this]() { emit progressChanged(); }, Qt::QueuedConnection);
+}
+
+void SnapshotManager::jobDiscarded(qint64 bytes)
+{
+    // Never ran: as if it had not been submitted
+    m_pendingBytes -= bytes;
+    m_jobsTotal--;
+}
+
+bool SnapshotManager::writeFrame(const RawFrame &frame, Format format, const QString &directory)
+{
+    const pic_info_t &info = frame.header.pic_info;
+    const QString base = QString("%1/pipe%2_frame%3_%4x%5_fmt%6")
+                         .arg(directory).arg(info.pipe_id).arg(info.frame_id)
+                         .arg(info.stride).arg(info.height).arg(info.format);
+
+    if (format == BayerTiff16 && info.format == PIX_FMT_SBGGR8) {
+        return writeBayerTiff16(frame, base + ".tiff");
+    }
+
+    if (format == RawBin || format == BayerTiff16) {
+        // Non-Bayer frames requested as DNG are kept raw instead
+        QFile file(base + ".bin");
+        if (!file.open(QIODevice::WriteOnly)) {
+            return false;
+        }
+        return file.write(frame.body) == frame.body.size();
+    }
+
+    QImage image = FrameConverter::convertRegion(frame.body, info.format, info.stride, info.height,
+                                                 QRect(0, 0, info.stride, info.height), 0);
+    if (image.isNull()) {
+        return false;
+    }
+    return format == Png ? image.save(base + ".png", "PNG") : writeRgbTiff(image, base + ".tiff");
+}
+
+// Minimal little-endian TIFF: one IFD, out-of-line values right after it,
+// then one uncompressed strip. Entries must be sorted by tag
+struct TiffEntry { quint16 tag; quint16 type; quint32 count; quint32 value; };
+enum { TIFF_BYTE = 1, TIFF_SHORT = 3, TIFF_LONG = 4 };
+
+static quint32 tiffExtraOffset(int entryCount)
+{
+    return 8 + 2 + entryCount * 12 + 4;
+}
+
+static QByteArray tiffHeader(const QList<TiffEntry> &entries, const QByteArray &extra)
+{
+    QByteArray header;
+    header.reserve(tiffExtraOffset(entries.size()) + extra.size());
+    auto put16 = [&header](quint16 v) { v = qToLittleEndian(v); header.append(reinterpret_cast<const char*>(&v), 2); };
+    auto put32 = [&header](quint32 v) { v = qToLittleEndian(v); header.append(reinterpret_cast<const char*>(&v), 4); };
+
+    header.append("II*\0", 4);
+    put32(8);
+    put16(static_cast<quint16>(entries.size()));
+    for (const TiffEntry &entry : entries) {
+        put16(entry.tag);
+        put16(entry.type);
+        put32(entry.count);
+        if (entry.type == TIFF_SHORT && entry.count == 1) {
+            // SHORT values are left-justified in the value field
+            put16(static_cast<quint16>(entry.value));
+            put16(0);
+        } else if (entry.type == TIFF_SHORT && entry.count == 2) {
+            put16(static_cast<quint16>(entry.value & 0xffff));
+            put16(static_cast<quint16>(entry.value >> 16));
+        } else {
+            put32(entry.value);
+        }
+    }
+    put32(0); // no next IFD
+    header.append(extra);
+    return header;
+}
+
+// 8-bit RGB baseline TIFF, Qt has no TIFF writer without qtimageformats
+bool SnapshotManager::writeRgbTiff(const QImage &source, const QString &path)
+{
+    const QImage image = source.convertToFormat(QImage::Format_RGB888);
+    const quint32 width = image.width();
+    const quint32 height = image.height();
+
+    const int entryCount = 11;
+    const quint32 bitsOffset = tiffExtraOffset(entryCount);
+    QByteArray extra;
+    for (int i = 0; i < 4; ++i) {
+        // 8,8,8 plus padding to keep the strip word aligned
+        const quint16 bits = qToLittleEndian<quint16>(i < 3 ? 8 : 0);
+        extra.append(reinterpret_cast<const char*>(&bits), 2);
+    }
+    const quint32 dataOffset = bitsOffset + extra.size();
+    const QList<TiffEntry> entries = {
+        { 254, TIFF_LONG, 1, 0 },                    // NewSubfileType
+        { 256, TIFF_LONG, 1, width },                // ImageWidth
+        { 257, TIFF_LONG, 1, height },               // ImageLength
+        { 258, TIFF_SHORT, 3, bitsOffset },          // BitsPerSample 8,8,8
+        { 259, TIFF_SHORT, 1, 1 },                   // Compression: none
+        { 262, TIFF_SHORT, 1, 2 },                   // PhotometricInterpretation: RGB
+        { 273, TIFF_LONG, 1, dataOffset },           // StripOffsets
+        { 277, TIFF_SHORT, 1, 3 },                   // SamplesPerPixel
+        { 278, TIFF_LONG, 1, height },               // RowsPerStrip
+        { 279, TIFF_LONG, 1, width * height * 3 },   // StripByteCounts
+        { 284, TIFF_SHORT, 1, 1 },                   // PlanarConfiguration
+    };
+    Q_ASSERT(entries.size() == entryCount);
+
+    const QByteArray header = tiffHeader(entries, extra);
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(header) != header.size()) {
+        return false;
+    }
+    // Scanlines are padded to 4 bytes in QImage, the strip is not
+    const qint64 rowBytes = static_cast<qint64>(width) * 3;
+    for (quint32 y = 0; y < height; ++y) {
+        if (file.write(reinterpret_cast<const char*>(image.constScanLine(y)), rowBytes) != rowBytes) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Minimal TIFF/EP: one uncompressed 16-bit CFA strip
+bool SnapshotManager::writeBayerTiff16(const RawFrame &frame, const QString &path)
+{
+    const quint32 width = frame.header.pic_info.stride;
+    const quint32 height = frame.header.pic_info.height;
+    if (frame.body.size() < static_cast<qint64>(width) * height) {
+        return false;
+    }
+
+    const int entryCount = 14;
+    const quint32 dataOffset = tiffExtraOffset(entryCount);
+    const quint32 cfaPattern = 2 | (1 << 8) | (1 << 16) | (0 << 24); // B G / G R, 0=R 1=G 2=B
+    const QList<TiffEntry> entries = {
+        { 254, TIFF_LONG, 1, 0 },                     // NewSubfileType
+        { 256, TIFF_LONG, 1, width },                 // ImageWidth
+        { 257, TIFF_LONG, 1, height },                // ImageLength
+        { 258, TIFF_SHORT, 1, 16 },                   // BitsPerSample
+        { 259, TIFF_SHORT, 1, 1 },                    // Compression: none
+        { 262, TIFF_SHORT, 1, 32803 },                // PhotometricInterpretation: CFA
+        { 273, TIFF_LONG, 1, dataOffset },            // StripOffsets
+        { 277, TIFF_SHORT, 1, 1 },                    // SamplesPerPixel
+        { 278, TIFF_LONG, 1, height },                // RowsPerStrip
+        { 279, TIFF_LONG, 1, width * height * 2 },    // StripByteCounts
+        { 284, TIFF_SHORT, 1, 1 },                    // PlanarConfiguration
+        { 33421, TIFF_SHORT, 2, 2 | (2 << 16) },      // CFARepeatPatternDim 2x2
+        { 33422, TIFF_BYTE, 4, cfaPattern },          // CFAPattern
+        { 50717, TIFF_LONG, 1, 255 },                 // WhiteLevel of the 8-bit source
+    };
+    Q_ASSERT(entries.size() == entryCount);
+
+    const QByteArray header = tiffHeader(entries, QByteArray());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(header) != header.size()) {
+        return false;
+    }
+
+    const uchar *pixels = reinterpret_cast<const uchar*>(frame.body.constData());
+    QByteArray row(width * 2, Qt::Uninitialized);
+    for (quint32 y = 0; y < height; ++y) {
+        quint16 *out = reinterpret_cast<quint16*>(row.data());
+        const uchar *in = pixels + static_cast<qint64>(y) * width;
+        for (quint32 x = 0; x < width; ++x) {
+            out[x] = qToLittleEndian(static_cast<quint16>(in[x]));
+        }
+        if (file.write(row) != row.size()) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,111 @@
+#ifndef SNAPSHOTMANAGER_H
+#define SNAPSHOTMANAGER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QQueue>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+
+#include "utils.h"
+
+// Burst snapshot / export of raw frames.
+// Optionally keeps a short pre-trigger ring per pipe (references to the received
+// bodies on TCP, copies on the shared-memory transport) and encodes/writes on a
+// background pool so the GUI thread only queues work.
+class SnapshotManager : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QString exportDirectory READ exportDirectory WRITE setExportDirectory NOTIFY exportDirectoryChanged)
+    Q_PROPERTY(int preTriggerFrames READ preTriggerFrames WRITE setPreTriggerFrames NOTIFY preTriggerFramesChanged)
+    Q_PROPERTY(bool busy READ busy NOTIFY progressChanged)
+    Q_PROPERTY(bool capturing READ capturing NOTIFY progressChanged)
+    Q_PROPERTY(double progress READ progress NOTIFY progressChanged)
+    Q_PROPERTY(QString status READ status NOTIFY progressChanged)
+
+public:
+    enum Format {
+        Png,
+        Tiff,
+        RawBin,
+        BayerTiff16   // 16-bit CFA TIFF with DNG style tags, Bayer formats only
+    };
+
+    explicit SnapshotManager(QObject *parent = nullptr);
+    ~SnapshotManager();
+
+    QString exportDirectory() const { return m_exportDirectory; }
+    void setExportDirectory(const QString &directory);
+    // Frames kept per pipe for exportLast(). Off by default: every kept frame is a
+    // full-res body counted against the governor budget
+    int preTriggerFrames() const { return m_preTriggerFrames; }
+    void setPreTriggerFrames(int frames);
+
+    bool busy() const { return m_jobsDone.load() < m_jobsTotal.load(); }
+    // captureNext() still waiting for frames
+    bool capturing() const { return m_captureRemaining > 0; }
+    // True while addFrame() has something to do with a frame
+    bool wantsFrames() const { return m_preTriggerFrames > 0 || m_captureRemaining > 0; }
+    double progress() const;
+    QString status() const;
+    int pendingJobs() const { return m_jobsTotal.load() - m_jobsDone.load(); }
+    quint64 failedJobs() const { return m_jobsFailed.load(); }
+    // Bytes held by the pre-trigger rings and by queued jobs
+    qint64 residentBytes() const { return m_ringBytes + m_pendingBytes.load(); }
+
+    // Called for every received frame; body must own its data (not fromRawData)
+    void addFrame(const cmd_header_new_t &header, const QByteArray &body);
+
+    // format: "png", "tiff", "bin" or "dng"
+    Q_INVOKABLE bool exportLast(const QString &format);
+    Q_INVOKABLE bool captureNext(int count, const QString &format);
+    Q_INVOKABLE void cancelCapture();
+
+signals:
+    void exportDirectoryChanged();
+    void preTriggerFramesChanged();
+    void progressChanged();
+
+private:
+    struct RawFrame {
+        cmd_header_new_t header;
+        QByteArray body;
+    };
+    class WriteJob;
+
+    static bool parseFormat(const QString &name, Format *format);
+    static bool writeFrame(const RawFrame &frame, Format format, const QString &directory);
+    static bool writeBayerTiff16(const RawFrame &frame, const QString &path);
+    static bool writeRgbTiff(const QImage &image, const QString &path);
+
+    QString newBurstDirectory();
+    void submit(const RawFrame &frame);
+    // Job accounting, finished runs on a pool thread
+    void jobFinished(qint64 bytes, bool ok);
+    void jobDiscarded(qint64 bytes);
+
+    // Pending job data is bounded so a long burst can never eat the memory budget
+    static const qint64 MaxPendingBytes = 512LL * 1024 * 1024;
+
+    QString m_exportDirectory;
+    int m_preTriggerFrames;
+    QHash<int, QQueue<RawFrame>> m_rings;
+    qint64 m_ringBytes;
+
+    // Active burst
+    Format m_format;
+    QString m_burstDirectory;
+    int m_captureRemaining;
+    int m_skippedFrames;
+
+    QThreadPool m_pool;
+    std::atomic<int> m_jobsTotal;
+    std::atomic<int> m_jobsDone;
+    std::atomic<quint64> m_jobsFailed;
+    std::atomic<qint64> m_pendingBytes;
+};
+
+#endif // SNAPSHOTMANAGER_H
@@ -0,0 +1,223 @@
+#include <QtAlgorithms>
+#include <QtEndian>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "StreamFramer.h"
+#include "FrameConverter.h"
+#include "Logger.h"
+
+static inline bool plausibleAt(const char *data, bool requireLen)
+{
+    cmd_header_new_t header;
+    memcpy(&header, data, sizeof(header));
+    return StreamFramer::validateHeader(header, requireLen) > 0;
+}
+
+StreamFramer::StreamFramer()
+    : m_readOffset(0)
+    , m_haveHeader(false)
+    , m_bodyLength(0)
+    , m_lenSeen(false)
+    , m_resyncing(false)
+    , m_resyncEvents(0)
+    , m_skippedBytes(0)
+{
+    memset(&m_header, 0, sizeof(m_header));
+}
+
+void StreamFramer::append(const QByteArray &data)
+{
+    m_buffer.append(data);
+}
+
+void StreamFramer::clear()
+{
+    m_buffer.clear();
+    m_readOffset = 0;
+    m_haveHeader = false;
+    memset(&m_header, 0, sizeof(m_header));
+    m_bodyLength = 0;
+    m_lenSeen = false;
+    m_resyncing = false;
+    m_resyncEvents = 0;
+    m_skippedBytes = 0;
+}
+
+bool StreamFramer::next(cmd_header_new_t *header, QByteArray *body)
+{
+    const qint64 headerSize = sizeof(cmd_header_new_t);
+
+    while (!m_haveHeader) {
+        if (bufferedBytes() < headerSize) {
+            compact();
+            return false;
+        }
+
+        memcpy(&m_header, m_buffer.constData() + m_readOffset, headerSize);
+        m_bodyLength = validateHeader(m_header, m_resyncing && m_lenSeen);
+        if (m_bodyLength > 0 && m_resyncing && m_header.len == 0) {
+            // Dark pixel data easily looks like a header with len 0; accept such a
+            // candidate only once the header after its body is here and valid too
+            const qint64 nextHeader = m_readOffset + headerSize + m_bodyLength;
+            if (m_buffer.size() < nextHeader + headerSize) {
+                compact();
+                return false;
+            }
+            if (!plausibleAt(m_buffer.constData() + nextHeader, false)) {
+                m_bodyLength = 0;
+            }
+        }
+        if (m_bodyLength > 0) {
+            if (m_header.len != 0) {
+                m_lenSeen = true;
+            }
+            if (m_resyncing) {
+                m_resyncing = false;
+                LOG_DEBUG("StreamFramer: back in sync after skipping" << m_skippedBytes << "bytes in total");
+            }
+            m_readOffset += headerSize;
+            m_haveHeader = true;
+            // Validated, so the size is bounded; grow once instead of per read
+            if (m_buffer.capacity() < m_readOffset + m_bodyLength) {
+                m_buffer.reserve(m_readOffset + m_bodyLength);
+            }
+            break;
+        }
+
+        if (!m_resyncing) {
+            m_resyncing = true;
+            m_resyncEvents++;
+            LOG_DEBUG("StreamFramer: invalid header - len:" << m_header.len << "type:" << m_header.type
+                      << "pipe:" << m_header.pic_info.pipe_id << "format:" << m_header.pic_info.format
+                      << "size:" << m_header.pic_info.width << "x" << m_header.pic_info.height
+                      << "stride:" << m_header.pic_info.stride << "- resyncing");
+        }
+
+        // The current offset is known bad, look from the next byte on
+        const qint64 from = m_readOffset + 1;
+        const qint64 skip = 1 + scanForHeader(m_buffer.constData() + from, m_buffer.size() - from, m_lenSeen);
+        m_readOffset += skip;
+        m_skippedBytes += skip;
+    }
+
+    if (bufferedBytes() < m_bodyLength) {
+        compact();
+        return false;
+    }
+
+    *header = m_header;
+    *body = m_buffer.mid(m_readOffset, m_bodyLength);
+    m_readOffset += m_bodyLength;
+    m_haveHeader = false;
+    m_bodyLength = 0;
+    return true;
+}
+
+qint64 StreamFramer::validateHeader(const cmd_header_new_t &header, bool requireLen)
+{
+    const pic_info_t &info = header.pic_info;
+    if (header.type > YUV_DATA || info.pipe_id > MaxPipeId) {
+        return 0;
+    }
+    // The body size follows the stride, like the rest of the player
+    if (info.width == 0 || info.height == 0 || info.stride < info.width
+        || info.stride > MaxDimension || info.height > MaxDimension) {
+        return 0;
+    }
+
+    const qint64 length = FrameConverter::bodyLength(info.format, info.stride, info.height);
+    if (length <= 0 || length > MaxBodyBytes) {
+        return 0;
+    }
+
+    // len counts the body or header + body; older senders leave it 0
+    const qint64 len = header.len;
+    if (len == 0 ? requireLen : (len != length && len != length + static_cast<qint64>(sizeof(cmd_header_new_t)))) {
+        return 0;
+    }
+    return length;
+}
+
+qint64 StreamFramer::scanForHeader(const char *data, qint64 size, bool requireLen)
+{
+    const qint64 last = size - static_cast<qint64>(sizeof(cmd_header_new_t));
+    if (last < 0) {
+        return 0;
+    }
+
+    // Test several offsets at once. Given the bounds above, the high bytes of
+    // type, pipe_id, format, width, height and stride are always zero while the
+    // low halves of height and stride are not; pixel data (even black frames)
+    // rarely matches all of that, so only a few offsets reach the full check
+    static const int ZeroBytes[] = { 5, 6, 7, 10, 11, 18, 19, 22, 23, 26, 27, 30, 31 };
+    static const int NonZeroWords[] = { 24, 28 };
+
+    qint64 pos = 0;
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    auto zeroAt = [zero](const char *p) {
+        return _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), zero);
+    };
+    for (; pos + 15 <= last; pos += 16) {
+        const char *block = data + pos;
+        __m128i hits = _mm_set1_epi8(-1);
+        for (int offset : ZeroBytes) {
+            hits = _mm_and_si128(hits, zeroAt(block + offset));
+        }
+        for (int offset : NonZeroWords) {
+            hits = _mm_andnot_si128(_mm_and_si128(zeroAt(block + offset), zeroAt(block + offset + 1)), hits);
+        }
+        quint32 mask = static_cast<quint32>(_mm_movemask_epi8(hits));
+        while (mask) {
+            const int bit = qCountTrailingZeroBits(mask);
+            if (plausibleAt(block + bit, requireLen)) {
+                return pos + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+#else
+    // 8 offsets per 64-bit word elsewhere (ARM included); zeroAt sets the top
+    // bit of exactly the zero bytes, byte i standing for offset pos + i
+    const quint64 low7 = Q_UINT64_C(0x7f7f7f7f7f7f7f7f);
+    auto zeroAt = [low7](const char *p) {
+        const quint64 word = qFromLittleEndian<quint64>(p);
+        return ~(((word & low7) + low7) | word | low7);
+    };
+    for (; pos + 7 <= last; pos += 8) {
+        const char *block = data + pos;
+        quint64 hits = ~low7;
+        for (int offset : ZeroBytes) {
+            hits &= zeroAt(block + offset);
+        }
+        for (int offset : NonZeroWords) {
+            hits &= ~(zeroAt(block + offset) & zeroAt(block + offset + 1));
+        }
+        while (hits) {
+            const int byte = qCountTrailingZeroBits(hits) / 8;
+            if (plausibleAt(block + byte, requireLen)) {
+                return pos + byte;
+            }
+            hits &= hits - 1;
+        }
+    }
+#endif
+
+    for (; pos <= last; ++pos) {
+        if (plausibleAt(data + pos, requireLen)) {
+            return pos;
+        }
+    }
+    return pos;
+}
+
+void StreamFramer::compact()
+{
+    if (m_readOffset > 0) {
+        m_buffer.remove(0, m_readOffset);
+        m_readOffset = 0;
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef STREAMFRAMER_H
+#define STREAMFRAMER_H
+
+#include <QByteArray>
+
+#include "utils.h"
+
+// Splits the TCP byte stream into header + body frames.
+// Every header is validated before its body is waited for (known format,
+// sane dimensions, len consistent with the format size). An invalid header
+// means the stream lost sync: the framer scans forward for the next plausible
+// header instead of reading pixel data as headers until reconnect.
+// While resyncing, a candidate must carry a consistent non-zero len; for
+// senders that never fill len in, the header after its body must be valid too.
+class StreamFramer
+{
+public:
+    // Upper bounds for a plausible header
+    static const quint32 MaxDimension = 16384;
+    static const quint32 MaxPipeId = 255;
+    static const qint64 MaxBodyBytes = 256LL * 1024 * 1024;
+
+    StreamFramer();
+
+    void append(const QByteArray &data);
+    // Take the next complete frame, false when more data is needed
+    bool next(cmd_header_new_t *header, QByteArray *body);
+    void clear();
+
+    qint64 bufferedBytes() const { return m_buffer.size() - m_readOffset; }
+    bool inSync() const { return !m_resyncing; }
+    quint64 resyncEvents() const { return m_resyncEvents; }
+    quint64 skippedBytes() const { return m_skippedBytes; }
+
+    // Body length for a valid header, 0 if the header is not plausible.
+    // requireLen rejects len == 0
+    static qint64 validateHeader(const cmd_header_new_t &header, bool requireLen = false);
+    // Offset of the first plausible header in data, or the first offset
+    // that cannot be checked yet because the header would run past size
+    static qint64 scanForHeader(const char *data, qint64 size, bool requireLen);
+
+private:
+    void compact();
+
+    // Unconsumed data starts at m_readOffset, consumed bytes are dropped in
+    // one move per read instead of once per header and body
+    QByteArray m_buffer;
+    qint64 m_readOffset;
+
+    bool m_haveHeader;
+    cmd_header_new_t m_header;
+    qint64 m_bodyLength;
+
+    // Set once the sender has been seen filling in len
+    bool m_lenSeen;
+    bool m_resyncing;
+    quint64 m_resyncEvents;
+    quint64 m_skippedBytes;
+};
+
+#endif // STREAMFRAMER_H
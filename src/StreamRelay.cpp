@@ -0,0 +1,158 @@
+#include <QHostAddress>
+
+#include "StreamRelay.h"
+#include "MetricsRegistry.h"
+#include "Logger.h"
+
+StreamRelay::StreamRelay(QObject *parent)
+    : QObject(parent)
+    , m_server(new QTcpServer(this))
+    , m_maxQueueFrames(8)
+    , m_maxQueueBytes(128LL * 1024 * 1024)
+    , m_droppedFrames(0)
+{
+    connect(m_server, &QTcpServer::newConnection, this, &StreamRelay::onNewConnection);
+}
+
+StreamRelay::~StreamRelay()
+{
+    stop();
+}
+
+bool StreamRelay::start(quint16 port)
+{
+    if (m_server->isListening()) {
+        stop();
+    }
+    m_droppedFrames = 0;
+    if (!m_server->listen(QHostAddress::Any, port)) {
+        LOG_DEBUG("StreamRelay listen failed on port" << port << ":" << m_server->errorString());
+        return false;
+    }
+    LOG_DEBUG("StreamRelay listening on port" << m_server->serverPort());
+    emit statsChanged();
+    return true;
+}
+
+void StreamRelay::stop()
+{
+    m_server->close();
+    const QList<QTcpSocket*> sockets = m_clients.keys();
+    m_clients.clear();
+    for (QTcpSocket *socket : sockets) {
+        socket->disconnect(this);
+        socket->abort();
+        socket->deleteLater();
+    }
+    emit statsChanged();
+}
+
+int StreamRelay::maxQueueDepth() const
+{
+    int depth = 0;
+    for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        depth = qMax(depth, static_cast<int>(it->queue.size()));
+    }
+    return depth;
+}
+
+void StreamRelay::setQueueLimits(int maxFrames, qint64 maxBytes)
+{
+    if (maxFrames > 0) {
+        m_maxQueueFrames = maxFrames;
+    }
+    if (maxBytes > 0) {
+        m_maxQueueBytes = maxBytes;
+    }
+}
+
+void StreamRelay::publish(const QByteArray &header, const QByteArray &body)
+{
+    if (m_clients.isEmpty()) {
+        return;
+    }
+
+    bool dropped = false;
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        Client &client = it.value();
+        client.queue.enqueue(Frame{ header, body });
+        client.queuedBytes += header.size() + body.size();
+
+        // Slow consumer: drop whole frames from the head, never the newest one
+        while (client.queue.size() > 1
+               && (client.queue.size() > m_maxQueueFrames || client.queuedBytes > m_maxQueueBytes)) {
+            const Frame oldest = client.queue.dequeue();
+            client.queuedBytes -= oldest.header.size() + oldest.body.size();
+            client.droppedFrames++;
+            m_droppedFrames++;
+            MetricsRegistry::instance().addDrop(MetricsRegistry::DropRelaySlowClient);
+            dropped = true;
+        }
+
+        pump(it.key(), client);
+    }
+
+    if (dropped) {
+        emit statsChanged();
+    }
+}
+
+void StreamRelay::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        Client client;
+        client.queuedBytes = 0;
+        client.sentFrames = 0;
+        client.droppedFrames = 0;
+        m_clients.insert(socket, client);
+
+        connect(socket, &QTcpSocket::bytesWritten, this, &StreamRelay::onClientBytesWritten);
+        connect(socket, &QTcpSocket::disconnected, this, &StreamRelay::onClientDisconnected);
+        // Downstream viewers only send start/stop commands, nothing to act on
+        connect(socket, &QTcpSocket::readyRead, socket, [socket]() { socket->readAll(); });
+
+        LOG_DEBUG("StreamRelay client connected:" << socket->peerAddress().toString() << socket->peerPort());
+    }
+    emit statsChanged();
+}
+
+void StreamRelay::onClientBytesWritten()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    auto it = m_clients.find(socket);
+    if (it != m_clients.end()) {
+        pump(socket, it.value());
+    }
+}
+
+void StreamRelay::onClientDisconnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    removeClient(socket);
+}
+
+void StreamRelay::pump(QTcpSocket *socket, Client &client)
+{
+    // Keep at most about one frame in the socket buffer, the rest waits in
+    // the bounded queue where it can still be dropped
+    while (!client.queue.isEmpty() && socket->bytesToWrite() < LowWatermark) {
+        const Frame frame = client.queue.dequeue();
+        client.queuedBytes -= frame.header.size() + frame.body.size();
+        socket->write(frame.header);
+        socket->write(frame.body);
+        client.sentFrames++;
+    }
+}
+
+void StreamRelay::removeClient(QTcpSocket *socket)
+{
+    auto it = m_clients.find(socket);
+    if (it == m_clients.end()) {
+        return;
+    }
+    LOG_DEBUG("StreamRelay client disconnected - sent:" << it->sentFrames << "dropped:" << it->droppedFrames);
+    m_clients.erase(it);
+    socket->disconnect(this);
+    socket->deleteLater();
+    emit statsChanged();
+}
@@ -0,0 +1,72 @@
+#ifndef STREAMRELAY_H
+#define STREAMRELAY_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QByteArray>
+#include <QHash>
+#include <QQueue>
+
+// Re-serves the received stream to downstream viewers using the same
+// cmd_header_new_t framing. Frames are queued per client by reference
+// (implicitly shared QByteArray), each queue is bounded and drops its oldest
+// whole frame when a client falls behind, so publish() never blocks.
+class StreamRelay : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StreamRelay(QObject *parent = nullptr);
+    ~StreamRelay();
+
+    bool start(quint16 port);
+    void stop();
+    bool isListening() const { return m_server->isListening(); }
+    quint16 port() const { return m_server->serverPort(); }
+    QString errorString() const { return m_server->errorString(); }
+
+    int clientCount() const { return m_clients.size(); }
+    quint64 droppedFrames() const { return m_droppedFrames; }
+    int maxQueueDepth() const;
+
+    void setQueueLimits(int maxFrames, qint64 maxBytes);
+
+    // Forward one frame to every client. body must own its data (not fromRawData).
+    void publish(const QByteArray &header, const QByteArray &body);
+
+signals:
+    void statsChanged();
+
+private slots:
+    void onNewConnection();
+    void onClientBytesWritten();
+    void onClientDisconnected();
+
+private:
+    struct Frame {
+        QByteArray header;
+        QByteArray body;
+    };
+
+    struct Client {
+        QQueue<Frame> queue;
+        qint64 queuedBytes;
+        quint64 sentFrames;
+        quint64 droppedFrames;
+    };
+
+    void pump(QTcpSocket *socket, Client &client);
+    void removeClient(QTcpSocket *socket);
+
+    // A client gets its next frame once its socket buffer is below this
+    static const qint64 LowWatermark = 256 * 1024;
+
+    QTcpServer *m_server;
+    QHash<QTcpSocket*, Client> m_clients;
+    int m_maxQueueFrames;
+    qint64 m_maxQueueBytes;
+    quint64 m_droppedFrames;
+};
+
+#endif // STREAMRELAY_H
@@ -3,6 +3,8 @@
 #include <QQmlContext>
 #include "NetworkClient.h"
 #include "ImageProvider.h"
+#include "SnapshotManager.h"
+#include "MetricsExporter.h"
 #include "Logger.h"
 
 int main(int argc, char *argv[])
@@ -17,6 +19,11 @@ int main(int argc, char *argv[])
     // 创建NetworkClient实例并设置为上下文属性
     NetworkClient networkClient;
     engine.rootContext()->setContextProperty("networkClient", &networkClient);
+    engine.rootContext()->setContextProperty("snapshotManager", networkClient.snapshotManager());
+
+    // Metrics endpoint / file dump, enabled by PLAYER_METRICS_PORT / PLAYER_METRICS_FILE
+    MetricsExporter metricsExporter;
+    metricsExporter.startFromEnvironment();
     
     // 创建图像提供器
     ImageProvider *imageProvider = new ImageProvider();
@@ -50,7 +50,7 @@ ApplicationWindow {
                         id: ipInput
                         Layout.fillWidth: true
                         text: "10.10.13.56"
-                        placeholderText: "Enter IP address"
+                        placeholderText: "Enter IP address or unix:<socket path>"
                         enabled: networkClient && !networkClient.connected
                     }
                 }
@@ -154,6 +154,200 @@ ApplicationWindow {
                     }
                 }
 
+                // Load governor status, tells operators why quality dropped
+                Rectangle {
+                    Layout.fillWidth: true
+                    Layout.preferredHeight: governorText.implicitHeight + 12
+                    color: (networkClient && networkClient.governorLevel > 0) ? "#fff3cd" : "white"
+                    border.color: (networkClient && networkClient.governorLevel > 0) ? "#ff9800" : "#cccccc"
+                    border.width: 1
+                    radius: 4
+
+                    Text {
+                        id: governorText
+                        anchors.fill: parent
+                        anchors.margins: 6
+                        text: "Load: " + (networkClient ? networkClient.governorStatus : "")
+                              + (networkClient && networkClient.governorSteps > 0 ? "\nGovernor steps: " + networkClient.governorSteps : "")
+                        font.pointSize: 8
+                        wrapMode: Text.WordWrap
+                    }
+                }
+
+                // Relay: re-serve the stream to other viewers
+                RowLayout {
+                    Layout.fillWidth: true
+                    spacing: 10
+
+                    TextField {
+                        id: relayPortInput
+                        Layout.preferredWidth: 80
+                        text: "10087"
+                        placeholderText: "Relay port"
+                        validator: IntValidator { bottom: 1; top: 65535 }
+                        enabled: networkClient && !networkClient.relayActive
+                    }
+
+                    Button {
+                        id: relayButton
+                        Layout.fillWidth: true
+                        text: (networkClient && networkClient.relayActive) ? "Stop Relay" : "Start Relay"
+                        enabled: networkClient && relayPortInput.text.length > 0
+
+                        onClicked: {
+                            if (networkClient.relayActive) {
+                                networkClient.stopRelay()
+                            } else {
+                                networkClient.startRelay(parseInt(relayPortInput.text))
+                            }
+                        }
+                    }
+                }
+
+                Text {
+                    visible: networkClient && networkClient.relayActive
+                    text: networkClient ? ("Relay clients: " + networkClient.relayClients
+                                           + ", dropped frames: " + networkClient.relayDroppedFrames) : ""
+                    font.pointSize: 8
+                }
+
+                // Multi-pipe synchronization (stereo / surround rigs)
+                RowLayout {
+                    Layout.fillWidth: true
+                    spacing: 6
+
+                    CheckBox {
+                        id: syncCheck
+                        text: "Sync pipes"
+                        checked: networkClient && networkClient.syncEnabled
+                        onToggled: networkClient.syncEnabled = checked
+                    }
+
+                    ComboBox {
+                        Layout.fillWidth: true
+                        model: ["By frame id", "By arrival"]
+                        currentIndex: networkClient ? networkClient.syncMode : 0
+                        onActivated: function(index) { networkClient.syncMode = index }
+                    }
+
+                    SpinBox {
+                        Layout.preferredWidth: 90
+                        from: 1
+                        to: 2000
+                        value: networkClient ? networkClient.syncDeadlineMs : 100
+                        editable: true
+                        onValueModified: networkClient.syncDeadlineMs = value
+                        ToolTip.visible: hovered
+                        ToolTip.text: "Latency deadline (ms)"
+                    }
+
+                    SpinBox {
+                        Layout.preferredWidth: 90
+                        from: 0
+                        to: 1000
+                        enabled: networkClient && networkClient.syncMode === 1
+                        value: networkClient ? networkClient.syncToleranceMs : 0
+                        editable: true
+                        textFromValue: function(value) { return value === 0 ? "auto" : value }
+                        valueFromText: function(text) { return text === "auto" ? 0 : parseInt(text) }
+                        onValueModified: networkClient.syncToleranceMs = value
+                        ToolTip.visible: hovered
+                        ToolTip.text: "Arrival tolerance (ms), auto follows the frame interval: "
+                                      + (networkClient ? networkClient.syncEffectiveToleranceMs : 0) + " ms"
+                    }
+                }
+
+                Text {
+                    visible: networkClient && networkClient.syncEnabled
+                    text: networkClient ? ("Sync sets: " + networkClient.syncCompleteSets + " complete, "
+                                           + networkClient.syncIncompleteSets + " incomplete, "
+                                           + networkClient.syncDroppedSets + " dropped, "
+                                           + networkClient.syncPendingSets + " pending") : ""
+                    font.pointSize: 8
+                }
+
+                Text {
+                    visible: networkClient && networkClient.syncEnabled && networkClient.syncMissingPipes.length > 0
+                    text: networkClient ? ("Not in sync sets, no frames from pipe: " + networkClient.syncMissingPipes.join(", ")) : ""
+                    color: "red"
+                    font.pointSize: 8
+                }
+
+                // Only shown once the stream has lost sync at least once
+                Text {
+                    visible: networkClient && networkClient.streamResyncs > 0
+                    text: networkClient ? ((networkClient.streamInSync ? "Stream resyncs: " : "Resynchronizing, resyncs: ")
+                                           + networkClient.streamResyncs + ", skipped bytes: "
+                                           + networkClient.streamSkippedBytes) : ""
+                    color: networkClient && networkClient.streamInSync ? "black" : "red"
+                    font.pointSize: 8
+                }
+
+                // Burst snapshot / export, written in the background
+                RowLayout {
+                    Layout.fillWidth: true
+                    spacing: 6
+
+                    ComboBox {
+                        id: exportFormat
+                        Layout.preferredWidth: 70
+                        model: ["png", "tiff", "bin", "dng"]
+                    }
+
+                    SpinBox {
+                        Layout.preferredWidth: 80
+                        from: 0
+                        to: 64
+                        value: snapshotManager ? snapshotManager.preTriggerFrames : 0
+                        editable: true
+                        onValueModified: snapshotManager.preTriggerFrames = value
+                        ToolTip.visible: hovered
+                        ToolTip.text: "Frames kept per pipe for \"Save last\" (0 = off)"
+                    }
+
+                    Button {
+                        Layout.fillWidth: true
+                        text: "Save last"
+                        enabled: snapshotManager !== null && snapshotManager.preTriggerFrames > 0
+                        onClicked: snapshotManager.exportLast(exportFormat.currentText)
+                    }
+
+                    SpinBox {
+                        id: captureCount
+                        Layout.preferredWidth: 90
+                        from: 1
+                        to: 10000
+                        value: 100
+                        editable: true
+                    }
+
+                    Button {
+                        Layout.fillWidth: true
+                        text: "Capture"
+                        enabled: snapshotManager !== null && networkClient && networkClient.connected
+                        onClicked: snapshotManager.captureNext(captureCount.value, exportFormat.currentText)
+                    }
+
+                    Button {
+                        text: "Cancel"
+                        enabled: snapshotManager !== null && (snapshotManager.busy || snapshotManager.capturing)
+                        onClicked: snapshotManager.cancelCapture()
+                    }
+                }
+
+                ProgressBar {
+                    Layout.fillWidth: true
+                    visible: snapshotManager && snapshotManager.busy
+                    value: snapshotManager ? snapshotManager.progress : 0
+                }
+
+                Text {
+                    Layout.fillWidth: true
+                    text: snapshotManager ? "Export: " + snapshotManager.status : ""
+                    font.pointSize: 8
+                    elide: Text.ElideMiddle
+                }
+
                 // Received Data Display
                 Rectangle {
                     Layout.fillWidth: true
@@ -236,8 +430,9 @@ ApplicationWindow {
                         // For 3 pipes, make the third one span both columns
                         Layout.columnSpan: (networkClient && networkClient.activePipes.length === 3 && index === 2) ? 2 : 1
                         color: "#ffffff"
-                        border.color: "#333333"
-                        border.width: 1
+                        // Focused pipe keeps full quality under load
+                        border.color: (networkClient && pipeId >= 0 && networkClient.focusedPipe === pipeId) ? "#2196F3" : "#333333"
+                        border.width: (networkClient && pipeId >= 0 && networkClient.focusedPipe === pipeId) ? 2 : 1
                         radius: 4
                         
                         property int pipeId: -1
@@ -276,6 +471,7 @@ ApplicationWindow {
                                 property int currentPipeId: parent.parent.pipeId
                                 property int frameValue: networkClient && currentPipeId >= 0 ? networkClient.getFrameForPipe(currentPipeId) : -1
                                 property real fpsValue: networkClient && currentPipeId >= 0 ? networkClient.getFpsForPipe(currentPipeId) : 0.0
+                                property string qualityValue: ""
                                 
                                 Row {
                                     anchors.centerIn: parent
@@ -302,6 +498,15 @@ ApplicationWindow {
                                         font.pointSize: 7
                                         anchors.verticalCenter: parent.verticalCenter
                                     }
+                                    
+                                    Text {
+                                        text: pipeIndicator.qualityValue
+                                        visible: pipeIndicator.qualityValue.length > 0
+                                        color: "#e65100"
+                                        font.pointSize: 7
+                                        font.bold: true
+                                        anchors.verticalCenter: parent.verticalCenter
+                                    }
                                 }
                                 
                                 // Update properties when frame info changes
@@ -319,6 +524,11 @@ ApplicationWindow {
                                             pipeIndicator.fpsValue = networkClient.getFpsForPipe(changedPipeId)
                                         }
                                     }
+                                    function onGovernorChanged() {
+                                        if (pipeIndicator.currentPipeId >= 0) {
+                                            pipeIndicator.qualityValue = networkClient.getQualityForPipe(pipeIndicator.currentPipeId)
+                                        }
+                                    }
                                 }
                             }
                             
@@ -332,10 +542,31 @@ ApplicationWindow {
                                 
                                 source: parent.parent.pipeId >= 0 ? "image://networkimage/pipe" + parent.parent.pipeId + "/" + Date.now() : ""
                                 
+                                // Click focuses, double click opens the 1:1 pixel inspector for this pipe
+                                MouseArea {
+                                    anchors.fill: parent
+                                    // Click to focus (or unfocus) this pipe
+                                    onClicked: {
+                                        var clickedPipe = pipeImage.parent.parent.pipeId
+                                        if (clickedPipe >= 0) {
+                                            networkClient.focusedPipe = (networkClient.focusedPipe === clickedPipe) ? -1 : clickedPipe
+                                        }
+                                    }
+                                    onDoubleClicked: {
+                                        if (pipeImage.parent.parent.pipeId >= 0) {
+                                            networkClient.inspectPipe = pipeImage.parent.parent.pipeId
+                                        }
+                                    }
+                                }
+                                
                                 // Handle image updates for this specific pipe
                                 Connections {
                                     target: networkClient
                                     function onPipeImageChanged(changedPipeId) {
+                                        // The inspector shows this pipe, no need to upload the full frame
+                                        if (networkClient.inspectPipe === changedPipeId) {
+                                            return
+                                        }
                                         if (pipeImage.parent.parent.pipeId === changedPipeId) {
                                             var newSource = "image://networkimage/pipe" + changedPipeId + "/" + Date.now()
                                             pipeImage.source = ""
@@ -352,6 +583,204 @@ ApplicationWindow {
                     }
                 }
             }
+
+            // Pixel inspector - pan/zoom with tiled, on-demand conversion
+            Rectangle {
+                id: inspector
+                anchors.fill: parent
+                anchors.margins: 4
+                color: "#202020"
+                radius: 4
+                visible: pipeId >= 0
+
+                property int pipeId: networkClient ? networkClient.inspectPipe : -1
+                property int frameWidth: 0
+                property int frameHeight: 0
+                property real zoom: 1.0
+                // Tiles are converted at 1/2^level of full resolution when zoomed out
+                property int level: zoom >= 1.0 ? 0 : Math.min(5, Math.floor(Math.log(1.0 / zoom) / Math.LN2))
+                property int tileSpan: (networkClient ? networkClient.tileSize : 256) * (1 << level)
+                property string frameStamp: ""
+                property string tileKey: ""
+                property var tiles: []
+                property string peekText: ""
+
+                onPipeIdChanged: {
+                    if (pipeId >= 0) {
+                        frameWidth = networkClient.getWidthForPipe(pipeId)
+                        frameHeight = networkClient.getHeightForPipe(pipeId)
+                        frameStamp = Date.now().toString()
+                        fitToView()
+                    } else {
+                        tiles = []
+                        tileKey = ""
+                    }
+                }
+                onLevelChanged: refreshTiles()
+                onZoomChanged: refreshTiles()
+
+                function fitToView() {
+                    if (frameWidth > 0 && frameHeight > 0 && flick.width > 0 && flick.height > 0) {
+                        zoom = Math.min(flick.width / frameWidth, flick.height / frameHeight)
+                    }
+                    flick.contentX = 0
+                    flick.contentY = 0
+                    refreshTiles()
+                }
+
+                function setZoomAt(newZoom, viewX, viewY) {
+                    newZoom = Math.max(0.02, Math.min(32.0, newZoom))
+                    var srcX = (flick.contentX + viewX) / zoom
+                    var srcY = (flick.contentY + viewY) / zoom
+                    zoom = newZoom
+                    flick.contentX = Math.max(0, Math.min(srcX * zoom - viewX, flick.contentWidth - flick.width))
+                    flick.contentY = Math.max(0, Math.min(srcY * zoom - viewY, flick.contentHeight - flick.height))
+                    refreshTiles()
+                }
+
+                // Only the tiles intersecting the viewport are requested
+                function refreshTiles() {
+                    if (pipeId < 0 || frameWidth <= 0 || frameHeight <= 0) {
+                        return
+                    }
+                    var span = tileSpan * zoom
+                    var lastX = Math.ceil(frameWidth / tileSpan) - 1
+                    var lastY = Math.ceil(frameHeight / tileSpan) - 1
+                    var tx0 = Math.max(0, Math.floor(flick.contentX / span))
+                    var ty0 = Math.max(0, Math.floor(flick.contentY / span))
+                    var tx1 = Math.min(lastX, Math.floor((flick.contentX + flick.width) / span))
+                    var ty1 = Math.min(lastY, Math.floor((flick.contentY + flick.height) / span))
+                    var key = level + ":" + tx0 + "," + ty0 + ":" + tx1 + "," + ty1
+                    if (key === tileKey) {
+                        return
+                    }
+                    var list = []
+                    for (var ty = ty0; ty <= ty1; ++ty) {
+                        for (var tx = tx0; tx <= tx1; ++tx) {
+                            list.push({ "tx": tx, "ty": ty })
+                        }
+                    }
+                    tileKey = key
+                    tiles = list
+                }
+
+                Connections {
+                    target: networkClient
+                    function onPipeImageChanged(changedPipeId) {
+                        if (inspector.pipeId === changedPipeId) {
+                            inspector.frameWidth = networkClient.getWidthForPipe(changedPipeId)
+                            inspector.frameHeight = networkClient.getHeightForPipe(changedPipeId)
+                            inspector.frameStamp = Date.now().toString()
+                            inspector.refreshTiles()
+                        }
+                    }
+                }
+
+                ColumnLayout {
+                    anchors.fill: parent
+                    anchors.margins: 2
+                    spacing: 2
+
+                    // Inspector toolbar with pixel-peek readout
+                    Rectangle {
+                        Layout.fillWidth: true
+                        Layout.preferredHeight: 28
+                        color: "#f0f0f0"
+                        radius: 3
+
+                        RowLayout {
+                            anchors.fill: parent
+                            anchors.leftMargin: 8
+                            anchors.rightMargin: 4
+                            spacing: 10
+
+                            Text {
+                                text: "PIPE " + inspector.pipeId + "  " + (inspector.zoom * 100).toFixed(0) + "%"
+                                font.pointSize: 8
+                                font.bold: true
+                            }
+
+                            Text {
+                                Layout.fillWidth: true
+                                text: inspector.peekText
+                                font.pointSize: 8
+                                font.family: "monospace"
+                                elide: Text.ElideRight
+                            }
+
+                            Button {
+                                text: "1:1"
+                                Layout.preferredHeight: 24
+                                onClicked: inspector.setZoomAt(1.0, flick.width / 2, flick.height / 2)
+                            }
+
+                            Button {
+                                text: "Fit"
+                                Layout.preferredHeight: 24
+                                onClicked: inspector.fitToView()
+                            }
+
+                            Button {
+                                text: "Close"
+                                Layout.preferredHeight: 24
+                                onClicked: networkClient.inspectPipe = -1
+                            }
+                        }
+                    }
+
+                    Flickable {
+                        id: flick
+                        Layout.fillWidth: true
+                        Layout.fillHeight: true
+                        clip: true
+                        contentWidth: inspector.frameWidth * inspector.zoom
+                        contentHeight: inspector.frameHeight * inspector.zoom
+                        boundsBehavior: Flickable.StopAtBounds
+
+                        onContentXChanged: inspector.refreshTiles()
+                        onContentYChanged: inspector.refreshTiles()
+                        onWidthChanged: inspector.refreshTiles()
+                        onHeightChanged: inspector.refreshTiles()
+
+                        Repeater {
+                            model: inspector.tiles
+
+                            Image {
+                                x: modelData.tx * inspector.tileSpan * inspector.zoom
+                                y: modelData.ty * inspector.tileSpan * inspector.zoom
+                                width: implicitWidth * inspector.zoom * (1 << inspector.level)
+                                height: implicitHeight * inspector.zoom * (1 << inspector.level)
+                                // Nearest neighbour when zoomed in so single pixels stay sharp
+                                smooth: inspector.zoom < 1.0
+                                cache: false
+                                source: "image://networkimage/tile/" + inspector.pipeId + "/" + inspector.level + "/"
+                                        + modelData.tx + "/" + modelData.ty + "/" + inspector.frameStamp
+                            }
+                        }
+
+                        MouseArea {
+                            width: flick.contentWidth
+                            height: flick.contentHeight
+                            acceptedButtons: Qt.NoButton
+                            hoverEnabled: true
+
+                            onPositionChanged: function(mouse) {
+                                var px = Math.floor(mouse.x / inspector.zoom)
+                                var py = Math.floor(mouse.y / inspector.zoom)
+                                var info = networkClient.peekPixel(inspector.pipeId, px, py)
+                                inspector.peekText = "(" + px + ", " + py + ") " + (info.text ? info.text : "")
+                            }
+                            onExited: inspector.peekText = ""
+                            onWheel: function(wheel) {
+                                var factor = wheel.angleDelta.y > 0 ? 1.25 : 0.8
+                                inspector.setZoomAt(inspector.zoom * factor,
+                                                    wheel.x - flick.contentX, wheel.y - flick.contentY)
+                                wheel.accepted = true
+                            }
+                        }
+                    }
+                }
+            }
         }
     }
 }
\ No newline at end of file
@@ -42,4 +42,30 @@ struct cmd_header_new_t {
     pic_info_t pic_info;
 };
 
+// Local transport ("unix:<path>" in connectToServer).
+// The server sends one shm_ring_info_t after accept, then one shm_frame_desc_t
+// per frame; the body lives in slot `slot` of the shared memory ring. The
+// client sends shm_release_t once it no longer reads that slot, the server
+// must not reuse a slot before it is released.
+#define SHM_RING_MAGIC   0x474E4952 // "RING"
+#define SHM_FRAME_MAGIC  0x4D415246 // "FRAM"
+#define SHM_RELEASE_MAGIC 0x454C4552 // "RELE"
+
+struct shm_ring_info_t {
+    uint32_t magic;
+    uint32_t slot_count;
+    uint32_t slot_size;
+    char name[64]; // POSIX shm name for shm_open
+};
+struct shm_frame_desc_t {
+    uint32_t magic;
+    uint32_t slot;
+    uint32_t body_len;
+    cmd_header_new_t header;
+};
+struct shm_release_t {
+    uint32_t magic;
+    uint32_t slot;
+};
+
 #endif // UTILS_H